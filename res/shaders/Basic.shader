@@ -3,14 +3,23 @@
 
 layout(location = 0) in vec4 position; // 0 should match with 0 in glVertexAttribPointer
 layout(location = 1) in vec2 texCoord;
+#ifdef INSTANCED
+layout(location = 2) in mat4 model; // Per instance, occupies locations 2 to 5
+#else
+uniform mat4 u_Model;
+#endif
 
 out vec2 v_TexCoord;
 
-uniform mat4 u_MVP;
+#include "include/Camera.glsl"
 
 void main()
 {
-    gl_Position = u_MVP*position;
+#ifdef INSTANCED
+    gl_Position = u_ViewProj * model * position;
+#else
+    gl_Position = u_ViewProj * u_Model * position;
+#endif
     v_TexCoord = texCoord;
 };
 
@@ -20,11 +29,17 @@ void main()
 layout(location = 0) out vec4 color; // 0 should match with 0 in glVertexAttribPointer
 in vec2 v_TexCoord;
 
-uniform vec4 u_Color;
+#ifdef TEXTURED
 uniform sampler2D u_Texture;
+#else
+uniform vec4 u_Color;
+#endif
 
 void main()
 {
-    vec4 texColor = texture(u_Texture, v_TexCoord);
-    color = texColor;
+#ifdef TEXTURED
+    color = texture(u_Texture, v_TexCoord);
+#else
+    color = u_Color;
+#endif
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) in float texIndex;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+flat out int v_Layer;
+
+uniform mat4 u_ViewProj;
+
+void main()
+{
+    gl_Position = u_ViewProj * position; // Vertices are already in world space
+    v_TexCoord = texCoord;
+    v_Color = color;
+    v_Layer = int(texIndex) - 1; // Index 0 is the untextured (white) quad
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+flat in int v_Layer;
+
+uniform sampler2DArray u_Array;
+
+void main()
+{
+    vec4 texColor = v_Layer < 0 ? vec4(1.0) : texture(u_Array, vec3(v_TexCoord, v_Layer));
+    color = texColor * v_Color;
+};
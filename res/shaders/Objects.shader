@@ -0,0 +1,34 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+#include "include/Camera.glsl"
+// A 16 KB window (the minimum GL_MAX_UNIFORM_BLOCK_SIZE) into the object array
+layout(std140) uniform Objects
+{
+    mat4 u_Models[256];
+};
+uniform int u_ObjectIndex;
+
+void main()
+{
+    gl_Position = u_ViewProj * u_Models[u_ObjectIndex] * position;
+    v_TexCoord = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+    color = texture(u_Texture, v_TexCoord);
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#shader vertex
+#version 330 core
+
+// Stands in for programs that are still compiling
+layout(location = 0) in vec4 position;
+
+#include "include/Camera.glsl"
+
+void main()
+{
+    gl_Position = u_ViewProj * position;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+    color = vec4(1.0, 0.0, 1.0, 0.5);
+};
\ No newline at end of file
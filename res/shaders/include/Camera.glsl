@@ -0,0 +1,5 @@
+// Uploaded once per frame, bound at CameraBinding (see UniformBuffer.h)
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProj;
+};
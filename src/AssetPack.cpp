@@ -0,0 +1,158 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    const uint32_t s_Magic = 0x4b504147; // "GAPK"
+    const uint32_t s_Version = 1;
+
+    struct Header
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t EntryCount;
+        uint32_t PathBytes; // The path strings follow the table of contents
+    };
+
+    uint64_t AlignUp(uint64_t offset)
+    {
+        return (offset + AssetPack::Alignment - 1) / AssetPack::Alignment * AssetPack::Alignment;
+    }
+}
+
+const AssetPack *AssetPack::s_Mounted = nullptr;
+
+AssetPack::AssetPack(const std::string &path) : m_File(path), m_Entries(nullptr), m_EntryCount(0), m_Paths(nullptr)
+{
+    if (!m_File.IsValid())
+        return;
+
+    /* Validate everything up front so lookups never need bounds checks */
+    const unsigned char *data = m_File.GetData();
+    size_t size = m_File.GetSize();
+    Header header;
+    if (size < sizeof(header))
+        return;
+    memcpy(&header, data, sizeof(header));
+    size_t tableSize = (size_t)header.EntryCount * sizeof(Entry);
+    if (header.Magic != s_Magic || header.Version != s_Version || sizeof(header) + tableSize + header.PathBytes > size)
+    {
+        std::cout << path << " is not an asset pack (or from another version)" << std::endl;
+        return;
+    }
+    const Entry *entries = (const Entry *)(data + sizeof(header));
+    for (uint32_t i = 0; i < header.EntryCount; ++i)
+    {
+        const Entry &entry = entries[i];
+        if ((uint64_t)entry.PathOffset + entry.PathLength > header.PathBytes || entry.Offset > size ||
+            entry.Size > size - entry.Offset)
+        {
+            std::cout << path << " is corrupt (entry " << i << ")" << std::endl;
+            return;
+        }
+    }
+
+    m_Entries = entries;
+    m_EntryCount = header.EntryCount;
+    m_Paths = (const char *)(data + sizeof(header) + tableSize);
+}
+
+AssetView AssetPack::GetAsset(uint32_t index) const
+{
+    const Entry &entry = m_Entries[index];
+    return {this, std::string_view(m_Paths + entry.PathOffset, entry.PathLength), m_File.GetData() + entry.Offset,
+            (size_t)entry.Size};
+}
+
+AssetView AssetPack::Find(std::string_view path) const
+{
+    uint32_t low = 0, high = m_EntryCount;
+    while (low < high)
+    {
+        uint32_t middle = (low + high) / 2;
+        const Entry &entry = m_Entries[middle];
+        int order = std::string_view(m_Paths + entry.PathOffset, entry.PathLength).compare(path);
+        if (order == 0)
+            return GetAsset(middle);
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return AssetView();
+}
+
+AssetView AssetPack::FindMounted(std::string_view path)
+{
+    return s_Mounted ? s_Mounted->Find(path) : AssetView();
+}
+
+bool AssetPack::Write(const std::string &path, std::vector<std::string> files)
+{
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    /* Lay out the table first, blobs follow the path strings */
+    Header header = {s_Magic, s_Version, (uint32_t)files.size(), 0};
+    std::vector<Entry> entries(files.size());
+    std::string paths;
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        entries[i].PathOffset = paths.size();
+        entries[i].PathLength = files[i].size();
+        paths += files[i];
+    }
+    header.PathBytes = paths.size();
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(Entry) + paths.size();
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        struct stat info;
+        if (stat(files[i].c_str(), &info) != 0)
+        {
+            std::cout << "Cannot pack " << files[i] << std::endl;
+            return false;
+        }
+        offset = AlignUp(offset);
+        entries[i].Offset = offset;
+        entries[i].Size = info.st_size;
+        offset += entries[i].Size;
+    }
+
+    /* Write to a temporary file first so a crash never leaves a torn pack */
+    std::string temporary = path + ".tmp";
+    FILE *out = fopen(temporary.c_str(), "wb");
+    if (!out)
+        return false;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(entries.data(), sizeof(Entry), entries.size(), out) == entries.size() &&
+              fwrite(paths.data(), 1, paths.size(), out) == paths.size();
+    const char zeros[Alignment] = {};
+    for (size_t i = 0; ok && i < files.size(); ++i)
+    {
+        long position = ftell(out);
+        ok = fwrite(zeros, 1, entries[i].Offset - position, out) == entries[i].Offset - position;
+        MappedFile file(files[i]); // Empty files do not map, they are stored empty
+        if (entries[i].Size && (!file.IsValid() || file.GetSize() != entries[i].Size))
+        {
+            std::cout << files[i] << " changed while packing" << std::endl;
+            ok = false;
+        }
+        ok = ok && fwrite(file.GetData(), 1, entries[i].Size, out) == entries[i].Size;
+    }
+    ok = fclose(out) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+class AssetPack;
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+// Points into a mapped pack, valid for as long as the pack is
+struct AssetView
+{
+    const AssetPack *Pack = nullptr;
+    std::string_view Path; // As stored, e.g. "res/shaders/Basic.shader"
+    const unsigned char *Data = nullptr;
+    size_t Size = 0;
+
+    inline bool IsValid() const { return Data != nullptr; }
+    inline std::string_view GetText() const { return std::string_view((const char *)Data, Size); }
+};
+
+/*
+ * Read-only archive of many files in one memory mapping:
+ *   header | table of contents (sorted by path) | path strings | blobs
+ * Every blob starts on an Alignment boundary, so views can be handed to
+ * SIMD code or the driver as they are. Lookups binary search the table;
+ * nothing is read or copied until a view's bytes are touched.
+ *
+ * One pack can be mounted globally; Texture(path) and Shader(path) look
+ * there before falling back to the loose file.
+ */
+class AssetPack
+{
+public:
+    static constexpr uint32_t Alignment = 64;
+
+private:
+    struct Entry
+    {
+        uint32_t PathOffset; // Into the path strings
+        uint32_t PathLength;
+        uint64_t Offset; // From the start of the file
+        uint64_t Size;
+    };
+
+    MappedFile m_File;
+    const Entry *m_Entries;
+    uint32_t m_EntryCount;
+    const char *m_Paths;
+
+    static const AssetPack *s_Mounted;
+
+public:
+    AssetPack(const std::string &path);
+    AssetPack(const AssetPack &) = delete;
+    AssetPack &operator=(const AssetPack &) = delete;
+
+    inline bool IsValid() const { return m_Entries != nullptr; }
+    AssetView Find(std::string_view path) const;
+    inline uint32_t GetAssetCount() const { return m_EntryCount; }
+    AssetView GetAsset(uint32_t index) const;
+
+    // Pass nullptr to unmount; the pack must outlive the mount. Not
+    // synchronized: mount before TextureLoader workers start looking.
+    static void Mount(const AssetPack *pack) { s_Mounted = pack; }
+    static const AssetPack *GetMounted() { return s_Mounted; }
+    // An invalid view when nothing is mounted or the path is not packed
+    static AssetView FindMounted(std::string_view path);
+
+    // Packs the files under the given (relative) paths, stored as given
+    static bool Write(const std::string &path, std::vector<std::string> files);
+};
@@ -0,0 +1,183 @@
+#include "BatchRenderer.h"
+
+#include <cstring>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+BatchRenderer::BatchRenderer() : m_Vertices(MaxVertices), m_QuadCount(0), m_TextureSlots{}, m_TextureSlotCount(1),
+                                 m_ArrayID(0), m_ViewProj(1.0f), m_VertexArray(),
+                                 m_VertexBuffer(MaxVertices * sizeof(QuadVertex), BufferMode::Stream),
+                                 m_IndexBuffer(CreateQuadIndices(MaxQuads).data(), MaxIndices),
+                                 m_Shader(ShaderLibrary::Get().Load("res/shaders/Batch.shader")),
+                                 m_ArrayShader(ShaderLibrary::Get().Load("res/shaders/BatchArray.shader")),
+                                 m_WhiteTexture(1, 1, std::array<unsigned char, 4>{255, 255, 255, 255}.data())
+{
+    /* Define vertices */
+    VertexBufferLayout layout;
+    layout.Push<float>(3); // Position
+    layout.Push<float>(2); // TexCoord
+    layout.Push<float>(4); // Color
+    layout.Push<float>(1); // TexIndex
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+    m_IndexBuffer.Bind(); // Store index buffer in the vertex array
+
+    /* Every sampler in the table points to its own texture slot */
+    int samplers[MaxTextureSlots];
+    for (uint i = 0; i < MaxTextureSlots; ++i)
+        samplers[i] = i;
+    m_Shader->Bind();
+    m_Shader->SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+    m_ArrayShader->Bind();
+    m_ArrayShader->SetUniform1i("u_Array", 0);
+
+    m_TextureSlots[0] = m_WhiteTexture.GetRendererID();
+}
+
+std::vector<uint> BatchRenderer::CreateQuadIndices(uint quadCount)
+{
+    std::vector<uint> indices(quadCount * 6);
+    for (uint i = 0, offset = 0; i < indices.size(); i += 6, offset += 4)
+    {
+        indices[i + 0] = offset + 0;
+        indices[i + 1] = offset + 1;
+        indices[i + 2] = offset + 2;
+        indices[i + 3] = offset + 2;
+        indices[i + 4] = offset + 3;
+        indices[i + 5] = offset + 0;
+    }
+    return indices;
+}
+
+void BatchRenderer::BeginBatch(const glm::mat4 &viewProj)
+{
+    m_ViewProj = viewProj;
+    m_QuadCount = 0;
+    m_TextureSlotCount = 1;
+    m_ArrayID = 0;
+}
+
+void BatchRenderer::EndBatch()
+{
+    Flush();
+}
+
+void BatchRenderer::Flush()
+{
+    if (m_QuadCount == 0)
+        return;
+
+    /* Copy into the ring; the GPU may still be reading earlier batches */
+    uint size = m_QuadCount * 4 * sizeof(QuadVertex);
+    memcpy(m_VertexBuffer.Map(size, sizeof(QuadVertex)), m_Vertices.data(), size);
+    m_VertexBuffer.Unmap();
+    int baseVertex = m_VertexBuffer.GetStreamOffset() / sizeof(QuadVertex);
+    Shader &shader = m_ArrayID ? *m_ArrayShader : *m_Shader;
+    if (m_ArrayID)
+        GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D_ARRAY, m_ArrayID);
+    else
+        for (uint i = 0; i < m_TextureSlotCount; ++i)
+            GLStateCache::Get().BindTexture(i, GL_TEXTURE_2D, m_TextureSlots[i]);
+    shader.Bind();
+    shader.SetUniformMat4f("u_ViewProj", m_ViewProj);
+
+    Renderer renderer;
+    renderer.Draw(m_VertexArray, m_IndexBuffer, shader, m_QuadCount * 6, 0, baseVertex);
+    m_Stats.DrawCount++;
+
+    m_QuadCount = 0;
+    m_TextureSlotCount = 1;
+    m_ArrayID = 0;
+}
+
+float BatchRenderer::GetTextureSlot(const Texture &texture)
+{
+    uint id = texture.GetRendererID();
+    for (uint i = 1; i < m_TextureSlotCount; ++i)
+        if (m_TextureSlots[i] == id)
+            return (float)i;
+
+    if (m_TextureSlotCount == MaxTextureSlots) // Table is full
+        Flush();
+    m_TextureSlots[m_TextureSlotCount] = id;
+    return (float)m_TextureSlotCount++;
+}
+
+BatchRenderer::QuadVertex *BatchRenderer::NextQuad()
+{
+    if (m_QuadCount == MaxQuads) // Vertex buffer is full
+        Flush();
+    m_Stats.QuadCount++;
+    return &m_Vertices[4 * m_QuadCount++];
+}
+
+void BatchRenderer::SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color)
+{
+    QuadVertex *v = NextQuad();
+    v[0] = {{position.x, position.y, 0.0f}, {0.0f, 0.0f}, color, 0.0f};
+    v[1] = {{position.x + size.x, position.y, 0.0f}, {1.0f, 0.0f}, color, 0.0f};
+    v[2] = {{position.x + size.x, position.y + size.y, 0.0f}, {1.0f, 1.0f}, color, 0.0f};
+    v[3] = {{position.x, position.y + size.y, 0.0f}, {0.0f, 1.0f}, color, 0.0f};
+}
+
+void BatchRenderer::SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const Texture &texture,
+                               const glm::vec4 &tint)
+{
+    SubmitQuad(position, size, texture, glm::vec2(0.0f), glm::vec2(1.0f), tint);
+}
+
+void BatchRenderer::SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const Texture &texture,
+                               const glm::vec2 &uvMin, const glm::vec2 &uvMax, const glm::vec4 &tint)
+{
+    if (m_QuadCount == MaxQuads || m_ArrayID)
+        Flush(); // Flushing resets the slot table, so do it before resolving the slot
+    float slot = GetTextureSlot(texture);
+    QuadVertex *v = NextQuad();
+    v[0] = {{position.x, position.y, 0.0f}, {uvMin.x, uvMin.y}, tint, slot};
+    v[1] = {{position.x + size.x, position.y, 0.0f}, {uvMax.x, uvMin.y}, tint, slot};
+    v[2] = {{position.x + size.x, position.y + size.y, 0.0f}, {uvMax.x, uvMax.y}, tint, slot};
+    v[3] = {{position.x, position.y + size.y, 0.0f}, {uvMin.x, uvMax.y}, tint, slot};
+}
+
+void BatchRenderer::SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureAtlas &atlas,
+                               const AtlasRegion &region, const glm::vec4 &tint)
+{
+    SubmitQuad(position, size, atlas.GetPage(region.Page), region.UVMin, region.UVMax, tint);
+}
+
+void BatchRenderer::SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureArray &array,
+                               uint layer, const glm::vec4 &tint)
+{
+    /* A batch samples either the 2D slot table or a single array */
+    if (m_QuadCount == MaxQuads || m_TextureSlotCount > 1 || (m_ArrayID && m_ArrayID != array.GetRendererID()))
+        Flush();
+    m_ArrayID = array.GetRendererID();
+    float index = (float)(layer + 1); // 0 stays the untextured quad
+    QuadVertex *v = NextQuad();
+    v[0] = {{position.x, position.y, 0.0f}, {0.0f, 0.0f}, tint, index};
+    v[1] = {{position.x + size.x, position.y, 0.0f}, {1.0f, 0.0f}, tint, index};
+    v[2] = {{position.x + size.x, position.y + size.y, 0.0f}, {1.0f, 1.0f}, tint, index};
+    v[3] = {{position.x, position.y + size.y, 0.0f}, {0.0f, 1.0f}, tint, index};
+}
+
+void BatchRenderer::SubmitQuad(const glm::mat4 &transform, const glm::vec4 &color)
+{
+    QuadVertex *v = NextQuad();
+    v[0] = {glm::vec3(transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)), {0.0f, 0.0f}, color, 0.0f};
+    v[1] = {glm::vec3(transform * glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)), {1.0f, 0.0f}, color, 0.0f};
+    v[2] = {glm::vec3(transform * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)), {1.0f, 1.0f}, color, 0.0f};
+    v[3] = {glm::vec3(transform * glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)), {0.0f, 1.0f}, color, 0.0f};
+}
+
+void BatchRenderer::SubmitQuad(const glm::mat4 &transform, const Texture &texture, const glm::vec4 &tint)
+{
+    if (m_QuadCount == MaxQuads || m_ArrayID)
+        Flush();
+    float slot = GetTextureSlot(texture);
+    QuadVertex *v = NextQuad();
+    v[0] = {glm::vec3(transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)), {0.0f, 0.0f}, tint, slot};
+    v[1] = {glm::vec3(transform * glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)), {1.0f, 0.0f}, tint, slot};
+    v[2] = {glm::vec3(transform * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)), {1.0f, 1.0f}, tint, slot};
+    v[3] = {glm::vec3(transform * glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)), {0.0f, 1.0f}, tint, slot};
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "TextureArray.h"
+#include "TextureAtlas.h"
+#include "ShaderLibrary.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Collects quads into one streaming vertex buffer and draws them with a
+ * single glDrawElements call. A flush only happens when the batch or the
+ * texture slot table is full, or when the batch ends.
+ */
+class BatchRenderer
+{
+public:
+    static constexpr uint MaxQuads = 10000;
+    static constexpr uint MaxVertices = MaxQuads * 4;
+    static constexpr uint MaxIndices = MaxQuads * 6;
+    static constexpr uint MaxTextureSlots = 16; // Must match u_Textures in Batch.shader
+
+    struct Stats
+    {
+        uint DrawCount = 0;
+        uint QuadCount = 0;
+    };
+
+private:
+    struct QuadVertex
+    {
+        glm::vec3 Position;
+        glm::vec2 TexCoord;
+        glm::vec4 Color;
+        float TexIndex;
+    };
+
+    std::vector<QuadVertex> m_Vertices;
+    uint m_QuadCount;
+    std::array<uint, MaxTextureSlots> m_TextureSlots; // Texture IDs, slot 0 is white
+    uint m_TextureSlotCount;
+    uint m_ArrayID; // Texture array of the current batch, 0 when drawing 2D textures
+    glm::mat4 m_ViewProj;
+    Stats m_Stats;
+
+    VertexArray m_VertexArray;
+    VertexBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    std::shared_ptr<Shader> m_Shader;
+    std::shared_ptr<Shader> m_ArrayShader;
+    Texture m_WhiteTexture;
+
+public:
+    BatchRenderer();
+    ~BatchRenderer() {}
+
+    void BeginBatch(const glm::mat4 &viewProj);
+    void EndBatch();
+    void Flush();
+
+    // Axis aligned quads (position is the bottom left corner)
+    void SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const glm::vec4 &color);
+    void SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const Texture &texture,
+                    const glm::vec4 &tint = glm::vec4(1.0f));
+    // Part of a texture, e.g. an atlas region
+    void SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const Texture &texture, const glm::vec2 &uvMin,
+                    const glm::vec2 &uvMax, const glm::vec4 &tint = glm::vec4(1.0f));
+    void SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureAtlas &atlas,
+                    const AtlasRegion &region, const glm::vec4 &tint = glm::vec4(1.0f));
+    // One layer of a texture array; switching between arrays and 2D textures flushes
+    void SubmitQuad(const glm::vec2 &position, const glm::vec2 &size, const TextureArray &array, uint layer,
+                    const glm::vec4 &tint = glm::vec4(1.0f));
+    // Arbitrary quads (transform is applied to the unit quad [0, 1] x [0, 1])
+    void SubmitQuad(const glm::mat4 &transform, const glm::vec4 &color);
+    void SubmitQuad(const glm::mat4 &transform, const Texture &texture, const glm::vec4 &tint = glm::vec4(1.0f));
+
+    inline const Stats &GetStats() const { return m_Stats; }
+    inline double GetFenceWaitMs() const { return m_VertexBuffer.GetStream()->GetFenceWaitMs(); }
+    void ResetStats() { m_Stats = Stats(); }
+
+private:
+    static std::vector<uint> CreateQuadIndices(uint quadCount);
+    float GetTextureSlot(const Texture &texture);
+    QuadVertex *NextQuad();
+};
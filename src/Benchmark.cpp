@@ -0,0 +1,374 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "FrameClock.h"
+#include "Framebuffer.h"
+#include "GLStateCache.h"
+#include "Renderer.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+static void RunFrame(test::Test &test, Renderer &renderer)
+{
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Clear();
+    /* One fixed step per frame, so every run simulates the same */
+    FrameClock &clock = FrameClock::Get();
+    clock.TickFixed();
+    test.OnUpdate(clock.GetDelta());
+    while (clock.Step())
+        test.OnFixedUpdate(clock.GetFixedStep());
+    test.OnRender();
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::Run(const test::TestMenu &testMenu) const
+{
+    std::vector<BenchmarkResult> results;
+    Framebuffer framebuffer(960, 540);
+    for (auto &entry : testMenu.GetTests())
+    {
+        if (!m_Options.TestName.empty() && entry.first != m_Options.TestName)
+            continue;
+
+        framebuffer.Bind();
+        test::Test *test = entry.second();
+        results.push_back(RunTest(entry.first, *test));
+
+        BenchmarkResult &result = results.back();
+        std::cout << std::left << std::setw(20) << result.Name << std::right << std::fixed << std::setprecision(3)
+                  << " cpu " << result.CpuMs.Median << " ms (p99 " << result.CpuMs.P99 << ")"
+                  << "  gpu " << result.GpuMs.Median << " ms (p99 " << result.GpuMs.P99 << ")"
+                  << "  draws " << result.DrawCalls << "  state " << result.StateChanges << std::endl;
+        BenchmarkSweep *sweep = test->GetBenchmarkSweep();
+        if (m_Options.Sweeps && sweep)
+            result.Passed = RunSweep(*sweep, *test);
+        delete test;
+        GLStateCache::Get().Invalidate(); // Tests may leave blend/depth state behind
+    }
+    return results;
+}
+
+BenchmarkResult BenchmarkRunner::RunTest(const std::string &name, test::Test &test) const
+{
+    Renderer renderer;
+    int frames = m_Options.MeasuredFrames;
+    std::vector<double> cpuMs(frames), gpuMs(frames);
+    std::vector<uint> queries(frames);
+    double drawCalls = 0.0, stateChanges = 0.0;
+
+    /* One timer query per measured frame, read back at the end so it never stalls */
+    GLCall(glGenQueries(frames, queries.data()));
+    for (int frame = -m_Options.WarmupFrames; frame < frames; ++frame)
+    {
+        bool measured = frame >= 0;
+        Renderer::ResetStats();
+        GLStateCache::Get().ResetStats();
+
+        if (measured)
+        {
+            GLCall(glBeginQuery(GL_TIME_ELAPSED, queries[frame]));
+        }
+        auto start = std::chrono::steady_clock::now();
+        RunFrame(test, renderer);
+        auto end = std::chrono::steady_clock::now();
+        if (!measured)
+            continue;
+        GLCall(glEndQuery(GL_TIME_ELAPSED));
+
+        cpuMs[frame] = std::chrono::duration<double, std::milli>(end - start).count();
+        drawCalls += Renderer::GetStats().DrawCalls;
+        stateChanges += GLStateCache::Get().GetStats().Issued;
+    }
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        GLuint64 elapsed = 0;
+        GLCall(glGetQueryObjectui64v(queries[frame], GL_QUERY_RESULT, &elapsed));
+        gpuMs[frame] = elapsed / 1.0e6;
+    }
+    GLCall(glDeleteQueries(frames, queries.data()));
+
+    BenchmarkResult result;
+    result.Name = name;
+    result.CpuMs = Summarize(cpuMs);
+    result.GpuMs = Summarize(gpuMs);
+    result.DrawCalls = frames ? drawCalls / frames : 0.0;
+    result.StateChanges = frames ? stateChanges / frames : 0.0;
+    return result;
+}
+
+bool BenchmarkRunner::RunSweep(BenchmarkSweep &sweep, test::Test &test) const
+{
+    /* The test measures itself, frames only need to keep coming */
+    Renderer renderer;
+    sweep.Start();
+    while (sweep.IsRunning())
+        RunFrame(test, renderer);
+    GLCall(glFinish());
+    sweep.Print(std::cout);
+    return sweep.IsPassed();
+}
+
+BenchmarkSummary BenchmarkRunner::Summarize(std::vector<double> samples)
+{
+    BenchmarkSummary summary;
+    if (samples.empty())
+        return summary;
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    summary.Min = samples.front();
+    summary.Median = n % 2 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    summary.P99 = samples[(size_t)std::ceil(0.99 * n) - 1]; // Nearest rank
+    return summary;
+}
+
+static void WriteJsonSummary(std::ostream &stream, const char *key, const BenchmarkSummary &summary)
+{
+    stream << "\"" << key << "\": {\"min\": " << summary.Min << ", \"median\": " << summary.Median
+           << ", \"p99\": " << summary.P99 << "}";
+}
+
+bool BenchmarkRunner::WriteJson(const std::string &path, const std::vector<BenchmarkResult> &results)
+{
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
+    stream << std::setprecision(6) << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult &result = results[i];
+        std::string name;
+        for (char c : result.Name) // Test names are plain text, only quotes need escaping
+        {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            name += c;
+        }
+        stream << "    {\"name\": \"" << name << "\", ";
+        WriteJsonSummary(stream, "cpu_ms", result.CpuMs);
+        stream << ", ";
+        WriteJsonSummary(stream, "gpu_ms", result.GpuMs);
+        stream << ", \"draw_calls\": " << result.DrawCalls << ", \"state_changes\": " << result.StateChanges
+               << ", \"passed\": " << (result.Passed ? "true" : "false") << "}"
+               << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    stream << "  ]\n}\n";
+    return (bool)stream;
+}
+
+bool BenchmarkRunner::WriteCsv(const std::string &path, const std::vector<BenchmarkResult> &results)
+{
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
+    stream << std::setprecision(6)
+           << "test,cpu_min_ms,cpu_median_ms,cpu_p99_ms,gpu_min_ms,gpu_median_ms,gpu_p99_ms,draw_calls,state_changes\n";
+    for (const BenchmarkResult &result : results)
+        stream << result.Name << ","
+               << result.CpuMs.Min << "," << result.CpuMs.Median << "," << result.CpuMs.P99 << ","
+               << result.GpuMs.Min << "," << result.GpuMs.Median << "," << result.GpuMs.P99 << ","
+               << result.DrawCalls << "," << result.StateChanges << "\n";
+    return (bool)stream;
+}
+
+static bool ParseDouble(const std::string &field, double &value)
+{
+    char *end = nullptr;
+    value = strtod(field.c_str(), &end);
+    if (end == field.c_str())
+        return false;
+    while (*end == ' ' || *end == '\r') // Padding or Windows line endings
+        ++end;
+    return *end == '\0';
+}
+
+bool BenchmarkRunner::ReadCsv(const std::string &path, std::map<std::string, BenchmarkResult> &results)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        return false;
+
+    std::string line;
+    getline(stream, line); // Header
+    for (int lineNumber = 2; getline(stream, line); ++lineNumber)
+    {
+        if (line.empty() || line == "\r")
+            continue;
+        std::stringstream ss(line);
+        std::string field;
+        std::vector<std::string> fields;
+        while (getline(ss, field, ','))
+            fields.push_back(field);
+        if (fields.size() != 9)
+        {
+            /* A skipped row would silently turn off the regression check for its test */
+            std::cout << path << ":" << lineNumber << ": expected 9 fields, got " << fields.size() << std::endl;
+            return false;
+        }
+
+        /* Hand edited baselines happen, a bad number fails the read instead of throwing */
+        double values[8];
+        for (int i = 0; i < 8; ++i)
+            if (!ParseDouble(fields[i + 1], values[i]))
+            {
+                std::cout << path << ":" << lineNumber << ": bad value '" << fields[i + 1] << "' for " << fields[0]
+                          << std::endl;
+                return false;
+            }
+
+        BenchmarkResult result;
+        result.Name = fields[0];
+        result.CpuMs = {values[0], values[1], values[2]};
+        result.GpuMs = {values[3], values[4], values[5]};
+        result.DrawCalls = values[6];
+        result.StateChanges = values[7];
+        results[result.Name] = result;
+    }
+    return true;
+}
+
+bool BenchmarkRunner::CompareToBaseline(const std::vector<BenchmarkResult> &results,
+                                        const std::map<std::string, BenchmarkResult> &baseline) const
+{
+    bool passed = true;
+    double limit = 1.0 + m_Options.Threshold / 100.0;
+    for (const BenchmarkResult &result : results)
+    {
+        auto it = baseline.find(result.Name);
+        if (it == baseline.end())
+        {
+            std::cout << result.Name << ": no baseline" << std::endl;
+            continue;
+        }
+        const BenchmarkResult &base = it->second;
+        bool cpuSlower = result.CpuMs.Median > base.CpuMs.Median * limit;
+        bool gpuSlower = result.GpuMs.Median > base.GpuMs.Median * limit;
+        std::cout << std::fixed << std::setprecision(3) << result.Name
+                  << ": cpu " << base.CpuMs.Median << " -> " << result.CpuMs.Median << " ms"
+                  << ", gpu " << base.GpuMs.Median << " -> " << result.GpuMs.Median << " ms"
+                  << (cpuSlower || gpuSlower ? "  REGRESSION" : "") << std::endl;
+        passed = passed && !cpuSlower && !gpuSlower;
+    }
+    return passed;
+}
+
+BenchmarkSweep::BenchmarkSweep(const std::vector<std::string> &steps, const std::vector<std::string> &metrics,
+                               int warmupFrames, int measuredFrames)
+    : m_Steps(steps), m_Metrics(metrics), m_WarmupFrames(warmupFrames), m_MeasuredFrames(measuredFrames), m_Step(-1),
+      m_Frame(0), m_ShowSpeedup(false)
+{
+    ASSERT(!steps.empty() && !metrics.empty() && measuredFrames > 0);
+}
+
+void BenchmarkSweep::Start()
+{
+    m_Samples.assign(m_Steps.size(), std::vector<std::vector<double>>(m_Metrics.size()));
+    m_Failures.clear();
+    m_Step = 0;
+    m_Frame = 0;
+}
+
+bool BenchmarkSweep::Record(std::initializer_list<double> values)
+{
+    ASSERT(values.size() == m_Metrics.size());
+    if (m_Step < 0)
+        return false;
+    if (m_Frame++ >= m_WarmupFrames)
+    {
+        uint metric = 0;
+        for (double value : values)
+            m_Samples[m_Step][metric++].push_back(value);
+    }
+    if (m_Frame < m_WarmupFrames + m_MeasuredFrames)
+        return false;
+
+    m_Frame = 0;
+    if (++m_Step < (int)m_Steps.size())
+        return false;
+    m_Step = -1;
+    return true;
+}
+
+void BenchmarkSweep::Check(bool passed, const std::string &message)
+{
+    if (passed)
+        return;
+    std::cout << "Check failed: " << message << std::endl;
+    m_Failures.push_back(message);
+}
+
+BenchmarkSummary BenchmarkSweep::GetSummary(uint step, uint metric) const
+{
+    if (step >= m_Samples.size() || metric >= m_Metrics.size())
+        return BenchmarkSummary();
+    return BenchmarkRunner::Summarize(m_Samples[step][metric]);
+}
+
+std::vector<std::string> BenchmarkSweep::FormatRows() const
+{
+    /* Medians, with the header as the first row */
+    char cell[64];
+    std::vector<std::string> rows(m_Steps.size() + 1);
+    size_t width = 0;
+    for (const std::string &step : m_Steps)
+        width = std::max(width, step.size());
+    rows[0] = std::string(width, ' ');
+    for (const std::string &metric : m_Metrics)
+    {
+        snprintf(cell, sizeof(cell), " %14s", metric.c_str());
+        rows[0] += cell;
+    }
+    if (m_ShowSpeedup)
+        rows[0] += "  Speedup";
+
+    double first = GetSummary(0, 0).Median;
+    for (uint step = 0; step < m_Steps.size(); ++step)
+    {
+        std::string &row = rows[step + 1];
+        row = m_Steps[step] + std::string(width - m_Steps[step].size(), ' ');
+        for (uint metric = 0; metric < m_Metrics.size(); ++metric)
+        {
+            snprintf(cell, sizeof(cell), " %14.3f", GetSummary(step, metric).Median);
+            row += cell;
+        }
+        double median = GetSummary(step, 0).Median;
+        if (m_ShowSpeedup)
+        {
+            snprintf(cell, sizeof(cell), " %7.2fx", median > 0.0 ? first / median : 0.0);
+            row += cell;
+        }
+    }
+    return rows;
+}
+
+void BenchmarkSweep::OnImGuiRender()
+{
+    if (m_Step < 0 && ImGui::Button("Run benchmark"))
+        Start();
+    else if (m_Step >= 0)
+        ImGui::Text("Running %d/%zu...", m_Step + 1, m_Steps.size());
+
+    ImGui::Text("Median of %d frames after %d warmup", m_MeasuredFrames, m_WarmupFrames);
+    for (const std::string &row : FormatRows())
+        ImGui::TextUnformatted(row.c_str());
+    for (const std::string &failure : m_Failures)
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "FAILED: %s", failure.c_str());
+}
+
+void BenchmarkSweep::Print(std::ostream &stream) const
+{
+    for (const std::string &row : FormatRows())
+        stream << "  " << row << std::endl;
+    for (const std::string &failure : m_Failures)
+        stream << "  FAILED: " << failure << std::endl;
+}
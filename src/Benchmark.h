@@ -0,0 +1,122 @@
+#pragma once
+
+#include <initializer_list>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Util.h"
+#include "tests/Test.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+struct BenchmarkOptions
+{
+    int WarmupFrames = 30;
+    int MeasuredFrames = 300;
+    std::string TestName;     // Empty runs every registered test
+    std::string JsonPath;     // Optional outputs
+    std::string CsvPath;
+    std::string BaselinePath; // CSV written by an earlier run
+    double Threshold = 10.0;  // Allowed slowdown against the baseline (%)
+    bool Sweeps = false;      // Also run every test's BenchmarkSweep
+};
+
+struct BenchmarkSummary
+{
+    double Min = 0.0;
+    double Median = 0.0;
+    double P99 = 0.0;
+};
+
+struct BenchmarkResult
+{
+    std::string Name;
+    BenchmarkSummary CpuMs; // OnUpdate + OnRender submission time
+    BenchmarkSummary GpuMs; // GL_TIME_ELAPSED over the same work
+    double DrawCalls = 0.0;    // Mean per frame
+    double StateChanges = 0.0; // Mean GL state calls issued per frame
+    bool Passed = true;        // False if a check of the test's sweep failed
+};
+
+/*
+ * Runs a test through a list of configurations ("steps"), each for a
+ * warmup and a measured window of frames, and keeps every sample of every
+ * metric. Once a frame the test applies the step's configuration if
+ * IsStepStart(), measures itself and calls Record(). Interactive tests
+ * show OnImGuiRender(); BenchmarkRunner runs the same sweep headless.
+ */
+class BenchmarkSweep
+{
+private:
+    std::vector<std::string> m_Steps;
+    std::vector<std::string> m_Metrics;
+    int m_WarmupFrames;
+    int m_MeasuredFrames;
+    int m_Step;  // -1 when idle
+    int m_Frame; // Within the step, warmup included
+    std::vector<std::vector<std::vector<double>>> m_Samples; // [step][metric][measured frame]
+    std::vector<std::string> m_Failures;
+    bool m_ShowSpeedup;
+
+public:
+    BenchmarkSweep(const std::vector<std::string> &steps, const std::vector<std::string> &metrics,
+                   int warmupFrames = 10, int measuredFrames = 60);
+    ~BenchmarkSweep() {}
+
+    void Start();
+    inline bool IsRunning() const { return m_Step >= 0; }
+    inline int GetStep() const { return m_Step; }
+    inline bool IsStepStart() const { return m_Step >= 0 && m_Frame == 0; }
+    // One value per metric for this frame, returns true on the frame that finishes the sweep
+    bool Record(std::initializer_list<double> values);
+
+    // Correctness checks that go with the numbers; a failure fails the headless run
+    void Check(bool passed, const std::string &message);
+    inline bool IsPassed() const { return m_Failures.empty(); }
+
+    // Over the measured frames of a step, zero before it ran
+    BenchmarkSummary GetSummary(uint step, uint metric) const;
+    // Adds the first metric of step 0 divided by each step's
+    inline void SetShowSpeedup(bool show) { m_ShowSpeedup = show; }
+
+    // "Run benchmark" button, progress and the table of medians
+    void OnImGuiRender();
+    void Print(std::ostream &stream) const;
+
+private:
+    std::vector<std::string> FormatRows() const;
+};
+
+/*
+ * Runs registered tests headless (into an offscreen Framebuffer) for a
+ * warmup plus a measured window and summarizes the per frame timings.
+ * With Sweeps, a test's BenchmarkSweep then runs to completion as well.
+ */
+class BenchmarkRunner
+{
+private:
+    BenchmarkOptions m_Options;
+
+public:
+    BenchmarkRunner(const BenchmarkOptions &options) : m_Options(options) {}
+
+    std::vector<BenchmarkResult> Run(const test::TestMenu &testMenu) const;
+
+    static bool WriteJson(const std::string &path, const std::vector<BenchmarkResult> &results);
+    static bool WriteCsv(const std::string &path, const std::vector<BenchmarkResult> &results);
+    static bool ReadCsv(const std::string &path, std::map<std::string, BenchmarkResult> &results);
+    static BenchmarkSummary Summarize(std::vector<double> samples);
+
+    // Prints a comparison, returns false if any median got slower than the threshold
+    bool CompareToBaseline(const std::vector<BenchmarkResult> &results,
+                           const std::map<std::string, BenchmarkResult> &baseline) const;
+
+private:
+    BenchmarkResult RunTest(const std::string &name, test::Test &test) const;
+    // Drives the sweep to the end, returns whether its checks passed
+    bool RunSweep(BenchmarkSweep &sweep, test::Test &test) const;
+};
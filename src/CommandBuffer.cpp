@@ -0,0 +1,122 @@
+#include "CommandBuffer.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+void CommandBuffer::BindShader(Shader &shader)
+{
+    if (m_Shader == &shader)
+        return;
+    m_Shader = &shader;
+    Write(CommandType::BindShader, &shader);
+}
+
+void CommandBuffer::BindTexture(const Texture &texture, uint slot)
+{
+    ASSERT(slot < GLStateCache::MaxTextureUnits);
+    if (m_Textures[slot] == &texture)
+        return;
+    m_Textures[slot] = &texture;
+    Write(CommandType::BindTexture, &texture, slot);
+}
+
+void CommandBuffer::BindGeometry(const VertexArray &va, const IndexBuffer &ib)
+{
+    if (m_VertexArray == &va && m_IndexBuffer == &ib)
+        return;
+    m_VertexArray = &va;
+    m_IndexBuffer = &ib;
+    Write(CommandType::BindGeometry, &va, &ib);
+}
+
+void CommandBuffer::SetUniformMat4f(UniformHandle handle, const glm::mat4 &matrix)
+{
+    Write(CommandType::SetUniformMat4f, handle, matrix);
+}
+
+void CommandBuffer::SetUniform4f(UniformHandle handle, const glm::vec4 &value)
+{
+    Write(CommandType::SetUniform4f, handle, value);
+}
+
+void CommandBuffer::Draw(uint indexCount, uint firstIndex, int baseVertex)
+{
+    Write(CommandType::Draw, indexCount, firstIndex, baseVertex);
+    m_DrawCount++;
+}
+
+void CommandBuffer::DrawInstanced(uint instanceCount)
+{
+    Write(CommandType::DrawInstanced, instanceCount);
+    m_DrawCount++;
+}
+
+void CommandBuffer::Clear()
+{
+    m_Data.clear();
+    m_CommandCount = 0;
+    m_DrawCount = 0;
+    m_Shader = nullptr;
+    m_VertexArray = nullptr;
+    m_IndexBuffer = nullptr;
+    for (const Texture *&texture : m_Textures)
+        texture = nullptr;
+}
+
+void CommandBuffer::Execute() const
+{
+    PROFILE_SCOPE("CommandBuffer::Execute");
+    Renderer renderer;
+    Shader *shader = nullptr;
+    const VertexArray *va = nullptr;
+    const IndexBuffer *ib = nullptr;
+
+    const unsigned char *cursor = m_Data.data();
+    const unsigned char *end = cursor + m_Data.size();
+    while (cursor < end)
+    {
+        CommandType type = (CommandType)*cursor++;
+        switch (type)
+        {
+        case CommandType::BindShader:
+            shader = Read<Shader *>(cursor);
+            shader->Bind();
+            break;
+        case CommandType::BindTexture:
+        {
+            const Texture *texture = Read<const Texture *>(cursor);
+            texture->Bind(Read<uint>(cursor));
+            break;
+        }
+        case CommandType::BindGeometry:
+            va = Read<const VertexArray *>(cursor);
+            ib = Read<const IndexBuffer *>(cursor);
+            break;
+        case CommandType::SetUniformMat4f:
+        {
+            UniformHandle handle = Read<UniformHandle>(cursor);
+            shader->SetUniformMat4f(handle, Read<glm::mat4>(cursor));
+            break;
+        }
+        case CommandType::SetUniform4f:
+        {
+            UniformHandle handle = Read<UniformHandle>(cursor);
+            glm::vec4 value = Read<glm::vec4>(cursor);
+            shader->SetUniform4f(handle, value.x, value.y, value.z, value.w);
+            break;
+        }
+        case CommandType::Draw:
+        {
+            uint indexCount = Read<uint>(cursor);
+            uint firstIndex = Read<uint>(cursor);
+            int baseVertex = Read<int>(cursor);
+            renderer.Draw(*va, *ib, *shader, indexCount ? indexCount : ib->GetCount(), firstIndex, baseVertex);
+            break;
+        }
+        case CommandType::DrawInstanced:
+            renderer.DrawInstanced(*va, *ib, *shader, Read<uint>(cursor));
+            break;
+        }
+    }
+}
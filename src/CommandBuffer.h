@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Renderer.h"
+#include "Texture.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Draw commands recorded on any thread and replayed on the GL thread.
+ * Commands are packed back to back into one byte vector: a one byte
+ * CommandType followed by its arguments, no padding. Recording touches no
+ * GL state, binds that repeat the previous one are dropped on the spot, and
+ * Clear() keeps the memory, so a buffer reused every frame stops allocating.
+ *
+ * The objects referenced must outlive Execute().
+ */
+class CommandBuffer
+{
+public:
+    enum class CommandType : uint8_t
+    {
+        BindShader,      // Shader *
+        BindTexture,     // const Texture *, uint slot
+        BindGeometry,    // const VertexArray *, const IndexBuffer *
+        SetUniformMat4f, // UniformHandle, glm::mat4
+        SetUniform4f,    // UniformHandle, glm::vec4
+        Draw,            // uint indexCount (0 is all), uint firstIndex, int baseVertex
+        DrawInstanced    // uint instanceCount
+    };
+
+private:
+    std::vector<unsigned char> m_Data;
+    uint m_CommandCount;
+    uint m_DrawCount;
+    /* Last recorded state, to drop redundant binds */
+    Shader *m_Shader;
+    const VertexArray *m_VertexArray;
+    const IndexBuffer *m_IndexBuffer;
+    const Texture *m_Textures[GLStateCache::MaxTextureUnits];
+
+public:
+    CommandBuffer() { Clear(); }
+
+    void BindShader(Shader &shader);
+    void BindTexture(const Texture &texture, uint slot = 0);
+    void BindGeometry(const VertexArray &va, const IndexBuffer &ib);
+    // Apply to the shader bound when they are replayed
+    void SetUniformMat4f(UniformHandle handle, const glm::mat4 &matrix);
+    void SetUniform4f(UniformHandle handle, const glm::vec4 &value);
+    void Draw(uint indexCount = 0, uint firstIndex = 0, int baseVertex = 0);
+    void DrawInstanced(uint instanceCount);
+
+    void Clear();
+    // GL thread only, buffers recorded in parallel are executed one after the other
+    void Execute() const;
+
+    inline size_t GetSize() const { return m_Data.size(); }
+    inline uint GetCommandCount() const { return m_CommandCount; }
+    inline uint GetDrawCount() const { return m_DrawCount; }
+
+private:
+    template <typename... Args>
+    void Write(CommandType type, const Args &...args)
+    {
+        size_t offset = m_Data.size();
+        m_Data.resize(offset + 1 + (sizeof(Args) + ... + 0));
+        m_Data[offset++] = (unsigned char)type;
+        ((std::memcpy(&m_Data[offset], &args, sizeof(Args)), offset += sizeof(Args)), ...);
+        m_CommandCount++;
+    }
+    template <typename T>
+    static T Read(const unsigned char *&cursor)
+    {
+        T value;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+};
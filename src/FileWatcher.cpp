@@ -0,0 +1,106 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+FileWatcher::FileWatcher() : m_LastPoll(std::chrono::steady_clock::now())
+{
+    m_InotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_InotifyFD < 0)
+        std::cout << "inotify not available, polling watched files every " << PollIntervalMs << " ms" << std::endl;
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_InotifyFD >= 0)
+        close(m_InotifyFD);
+}
+
+void FileWatcher::Watch(const std::string &filepath)
+{
+    for (const WatchedFile &file : m_Files)
+        if (file.Path == filepath)
+            return;
+
+    size_t slash = filepath.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : filepath.substr(0, slash);
+    std::string name = slash == std::string::npos ? filepath : filepath.substr(slash + 1);
+    m_Files.push_back({filepath, directory, name, GetModifiedNs(filepath)});
+
+    if (m_InotifyFD < 0)
+        return;
+    for (auto &entry : m_Directories)
+        if (entry.second == directory)
+            return;
+    /* In place saves end in IN_CLOSE_WRITE, rename saves in IN_MOVED_TO; IN_CREATE would see empty files */
+    int wd = inotify_add_watch(m_InotifyFD, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd >= 0)
+        m_Directories[wd] = directory;
+    else
+        std::cout << "Warning: cannot watch " << directory << std::endl;
+}
+
+std::vector<std::string> FileWatcher::Poll()
+{
+    return m_InotifyFD >= 0 ? PollInotify() : PollStat();
+}
+
+std::vector<std::string> FileWatcher::PollInotify()
+{
+    std::vector<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(m_InotifyFD, buffer, sizeof(buffer))) > 0)
+    {
+        for (char *it = buffer; it < buffer + length;)
+        {
+            const inotify_event *event = (const inotify_event *)it;
+            it += sizeof(inotify_event) + event->len;
+
+            auto directory = m_Directories.find(event->wd);
+            if (directory == m_Directories.end() || event->len == 0)
+                continue;
+            for (const WatchedFile &file : m_Files)
+                if (file.Directory == directory->second && file.Name == event->name &&
+                    std::find(changed.begin(), changed.end(), file.Path) == changed.end())
+                    changed.push_back(file.Path);
+        }
+    }
+    return changed;
+}
+
+std::vector<std::string> FileWatcher::PollStat()
+{
+    std::vector<std::string> changed;
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_LastPoll < std::chrono::milliseconds(PollIntervalMs))
+        return changed;
+    m_LastPoll = now;
+
+    for (WatchedFile &file : m_Files)
+    {
+        int64_t modified = GetModifiedNs(file.Path);
+        if (modified != file.ModifiedNs)
+        {
+            file.ModifiedNs = modified;
+            if (modified != 0) // Mid-save, the file may briefly not exist
+                changed.push_back(file.Path);
+        }
+    }
+    return changed;
+}
+
+int64_t FileWatcher::GetModifiedNs(const std::string &filepath)
+{
+    struct stat info;
+    if (stat(filepath.c_str(), &info) != 0)
+        return 0;
+    return (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Reports files that were written since the last Poll(). Uses a
+ * non-blocking inotify descriptor on the parent directories (editors often
+ * save by renaming a temporary file), or stat() on every file at most every
+ * PollIntervalMs when inotify is unavailable. Poll() never blocks.
+ */
+class FileWatcher
+{
+public:
+    static constexpr int PollIntervalMs = 250;
+
+private:
+    struct WatchedFile
+    {
+        std::string Path;
+        std::string Directory;
+        std::string Name;
+        int64_t ModifiedNs; // Polling fallback only
+    };
+
+    int m_InotifyFD; // -1 when polling
+    std::unordered_map<int, std::string> m_Directories; // Watch descriptor -> directory
+    std::vector<WatchedFile> m_Files;
+    std::chrono::steady_clock::time_point m_LastPoll;
+
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    void Watch(const std::string &filepath);
+    // Paths as passed to Watch(), each at most once per call
+    std::vector<std::string> Poll();
+
+    inline bool IsPolling() const { return m_InotifyFD < 0; }
+
+private:
+    std::vector<std::string> PollInotify();
+    std::vector<std::string> PollStat();
+    static int64_t GetModifiedNs(const std::string &filepath);
+};
@@ -0,0 +1,201 @@
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+#include <GLFW/glfw3.h>
+
+#include "vendor/imgui/imgui.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+FrameClock::FrameClock()
+    : m_Started(false), m_Delta(0.0), m_Accumulator(0.0), m_FixedStep(DefaultFixedStep), m_Steps(0),
+      m_Pacing(FramePacing::VSync), m_TargetFps(60), m_SpinMs(1.5), m_IntervalChanged(false),
+      m_AdaptiveSupported(false)
+{
+    ResetStats();
+}
+
+FrameClock &FrameClock::Get()
+{
+    static FrameClock clock;
+    return clock;
+}
+
+void FrameClock::Tick()
+{
+    Clock::time_point now = Clock::now();
+    double delta = m_Started ? std::chrono::duration<double>(now - m_Last).count() : 0.0;
+    m_Last = now;
+    if (m_Started)
+        Record(delta * 1000.0);
+    m_Started = true;
+    Tick(std::min(delta, MaxDelta));
+}
+
+void FrameClock::Tick(double delta)
+{
+    m_Delta = delta;
+    m_Accumulator += delta;
+    m_Steps = 0;
+
+    /* Running behind for good: drop steps instead of spiralling further behind */
+    double maxBacklog = MaxStepsPerFrame * m_FixedStep;
+    if (m_Accumulator > maxBacklog)
+    {
+        uint dropped = (uint)std::ceil((m_Accumulator - maxBacklog) / m_FixedStep);
+        m_Accumulator = std::max(0.0, m_Accumulator - dropped * m_FixedStep);
+        m_Stats.DroppedSteps += dropped;
+    }
+}
+
+void FrameClock::TickFixed()
+{
+    /* m_FixedStep itself, GetFixedStep() is rounded to float and may fall short of it */
+    m_Delta = m_FixedStep;
+    m_Accumulator = m_FixedStep;
+    m_Steps = 0;
+}
+
+bool FrameClock::Step()
+{
+    if (m_Accumulator < m_FixedStep)
+        return false;
+    m_Accumulator -= m_FixedStep;
+    m_Steps++;
+    return true;
+}
+
+void FrameClock::SetFixedStep(double step)
+{
+    /* Keep the interpolation factor, not the time, so nothing jumps */
+    m_Accumulator = m_Accumulator / m_FixedStep * step;
+    m_FixedStep = step;
+}
+
+void FrameClock::SetPacing(FramePacing pacing)
+{
+    m_Pacing = pacing;
+    m_Deadline = Clock::time_point();
+    m_IntervalChanged = true;
+}
+
+void FrameClock::SetTargetFps(int fps)
+{
+    m_TargetFps = std::max(1, fps);
+    m_Deadline = Clock::time_point();
+}
+
+void FrameClock::WaitForTarget()
+{
+    if (m_Pacing != FramePacing::TargetFps)
+    {
+        m_Stats.WaitMs = 0.0;
+        return;
+    }
+
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_TargetFps));
+    Clock::time_point start = Clock::now();
+    /* First frame, or more than a frame late: start over from now rather than rush to catch up */
+    if (m_Deadline == Clock::time_point() || start > m_Deadline + period)
+        m_Deadline = start;
+
+    /* Sleep is cheap but coarse, so stop short of the deadline and spin the rest */
+    auto spin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(m_SpinMs));
+    if (start < m_Deadline - spin)
+        std::this_thread::sleep_until(m_Deadline - spin);
+    while (Clock::now() < m_Deadline)
+        std::this_thread::yield();
+
+    m_Stats.WaitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    m_Deadline += period;
+}
+
+void FrameClock::ApplySwapInterval()
+{
+    if (!m_IntervalChanged.exchange(false))
+        return;
+
+    m_AdaptiveSupported =
+        glfwExtensionSupported("GLX_EXT_swap_control_tear") || glfwExtensionSupported("WGL_EXT_swap_control_tear");
+    int interval = 0;
+    if (m_Pacing == FramePacing::VSync)
+        interval = 1;
+    else if (m_Pacing == FramePacing::Adaptive)
+        interval = m_AdaptiveSupported ? -1 : 1;
+    glfwSwapInterval(interval);
+}
+
+void FrameClock::ResetStats()
+{
+    m_Histogram.fill(0);
+    m_History.fill(0.0f);
+    m_HistoryIndex = 0;
+    m_TotalMs = 0.0;
+    m_Stats = Stats();
+}
+
+void FrameClock::Record(double frameMs)
+{
+    m_Histogram[std::min((uint)frameMs, HistogramBuckets - 1)]++;
+    m_History[m_HistoryIndex] = (float)frameMs;
+    m_HistoryIndex = (m_HistoryIndex + 1) % HistorySize;
+
+    m_Stats.Frames++;
+    m_TotalMs += frameMs;
+    m_Stats.AverageMs = m_TotalMs / m_Stats.Frames;
+    m_Stats.MaxMs = std::max(m_Stats.MaxMs, frameMs);
+    m_Stats.P50Ms = Percentile(0.5);
+    m_Stats.P99Ms = Percentile(0.99);
+}
+
+double FrameClock::Percentile(double fraction) const
+{
+    /* Upper edge of the bucket the percentile falls in */
+    uint target = (uint)std::ceil(fraction * m_Stats.Frames);
+    uint count = 0;
+    for (uint bucket = 0; bucket < HistogramBuckets; ++bucket)
+    {
+        count += m_Histogram[bucket];
+        if (count >= target)
+            return bucket + 1.0;
+    }
+    return HistogramBuckets;
+}
+
+void FrameClock::OnImGuiRender()
+{
+    ImGui::Begin("Frame Pacing");
+    const char *modes[] = {"VSync", "Uncapped", "Target FPS", "Adaptive"};
+    int pacing = (int)m_Pacing.load();
+    if (ImGui::Combo("Pacing", &pacing, modes, 4))
+        SetPacing((FramePacing)pacing);
+    if (m_Pacing == FramePacing::TargetFps)
+    {
+        int fps = m_TargetFps;
+        if (ImGui::SliderInt("Target FPS", &fps, 10, 360))
+            SetTargetFps(fps);
+        ImGui::Text("Waited %.2f ms last frame", m_Stats.WaitMs);
+    }
+    else if (m_Pacing == FramePacing::Adaptive && !m_AdaptiveSupported)
+        ImGui::Text("No EXT_swap_control_tear, using vsync");
+
+    ImGui::Text("%u frames: average %.2f ms, median < %.0f ms, 99%% < %.0f ms, max %.2f ms", m_Stats.Frames,
+                m_Stats.AverageMs, m_Stats.P50Ms, m_Stats.P99Ms, m_Stats.MaxMs);
+    ImGui::Text("Fixed step %.2f ms, %u steps this frame, %u dropped", m_FixedStep * 1000.0, m_Steps,
+                m_Stats.DroppedSteps);
+    ImGui::PlotLines("Frame (ms)", m_History.data(), HistorySize, m_HistoryIndex, nullptr, 0.0f, 50.0f,
+                     ImVec2(0, 60));
+
+    std::array<float, HistogramBuckets> histogram;
+    std::copy(m_Histogram.begin(), m_Histogram.end(), histogram.begin());
+    ImGui::PlotHistogram("1 ms buckets", histogram.data(), HistogramBuckets, 0, nullptr, 0.0f, FLT_MAX,
+                         ImVec2(0, 60));
+    if (ImGui::Button("Reset"))
+        ResetStats();
+    ImGui::End();
+}
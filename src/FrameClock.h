@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+enum class FramePacing
+{
+    VSync,     // Swap interval 1
+    Uncapped,  // Swap interval 0, as fast as possible (benchmarks)
+    TargetFps, // Swap interval 0, sleep and then spin until the next deadline
+    Adaptive   // Swap interval -1: vsync, but late frames tear instead of waiting a whole refresh
+};
+
+/*
+ * Frame timing for the main loop:
+ *
+ *   clock.Tick();
+ *   test->OnUpdate(clock.GetDelta());
+ *   while (clock.Step())
+ *       test->OnFixedUpdate(clock.GetFixedStep());
+ *   ... render, blending the last two fixed states by GetInterpolation()
+ *   clock.WaitForTarget();
+ *   clock.ApplySwapInterval(); // On the thread owning the context
+ *   glfwSwapBuffers(window);
+ *
+ * Tick() also records the frame time in a histogram of 1 ms buckets.
+ */
+class FrameClock
+{
+public:
+    static constexpr double DefaultFixedStep = 1.0 / 60.0;
+    static constexpr double MaxDelta = 0.25;    // Longer frames (breakpoints, loading) are clamped
+    static constexpr uint MaxStepsPerFrame = 8; // Fixed steps beyond this are dropped
+    static constexpr uint HistogramBuckets = 50; // 1 ms each, the last one also counts anything longer
+    static constexpr uint HistorySize = 240;
+
+    struct Stats
+    {
+        uint Frames = 0;
+        double AverageMs = 0.0;
+        double P50Ms = 0.0, P99Ms = 0.0; // Bucket resolution
+        double MaxMs = 0.0;
+        double WaitMs = 0.0;    // Sleep + spin of the last frame
+        uint DroppedSteps = 0;  // Fixed steps skipped to catch up
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_Last;
+    Clock::time_point m_Deadline; // Next TargetFps frame
+    bool m_Started;
+    double m_Delta;
+    double m_Accumulator;
+    double m_FixedStep;
+    uint m_Steps; // Taken this frame
+
+    std::atomic<FramePacing> m_Pacing; // Read by the render thread in ApplySwapInterval()
+    int m_TargetFps;
+    double m_SpinMs; // Spin this long before a deadline, sleeping overshoots by about this much
+    std::atomic<bool> m_IntervalChanged;
+    std::atomic<bool> m_AdaptiveSupported;
+
+    std::array<uint, HistogramBuckets> m_Histogram;
+    std::array<float, HistorySize> m_History; // Frame times in ms, ring buffer
+    uint m_HistoryIndex;
+    double m_TotalMs;
+    Stats m_Stats;
+
+    FrameClock();
+
+public:
+    static FrameClock &Get();
+
+    // Measures the time since the previous Tick()
+    void Tick();
+    // Advances by a given delta instead
+    void Tick(double delta);
+    // Advances by exactly one fixed step, so Step() is true exactly once (reproducible headless runs)
+    void TickFixed();
+    // True while another fixed step is due
+    bool Step();
+
+    inline float GetDelta() const { return (float)m_Delta; }
+    inline float GetFixedStep() const { return (float)m_FixedStep; }
+    void SetFixedStep(double step);
+    // How far between the previous and the latest fixed step this frame is, 0 to 1
+    inline float GetInterpolation() const { return (float)(m_Accumulator / m_FixedStep); }
+
+    void SetPacing(FramePacing pacing);
+    inline FramePacing GetPacing() const { return m_Pacing; }
+    void SetTargetFps(int fps);
+    inline int GetTargetFps() const { return m_TargetFps; }
+    // TargetFps only, call just before presenting
+    void WaitForTarget();
+    // Sets the swap interval if the pacing changed, on whichever thread owns the context
+    void ApplySwapInterval();
+    inline bool IsAdaptiveSupported() const { return m_AdaptiveSupported; }
+
+    inline const Stats &GetStats() const { return m_Stats; }
+    inline const std::array<uint, HistogramBuckets> &GetHistogram() const { return m_Histogram; }
+    void ResetStats();
+    void OnImGuiRender();
+
+private:
+    void Record(double frameMs);
+    double Percentile(double fraction) const;
+};
@@ -0,0 +1,59 @@
+#include "Framebuffer.h"
+
+#include <fstream>
+#include <vector>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+Framebuffer::Framebuffer(int width, int height) : m_RendererID(0), m_ColorAttachment(0), m_DepthAttachment(0),
+                                                  m_Width(width), m_Height(height)
+{
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+    GLCall(glGenRenderbuffers(1, &m_ColorAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorAttachment));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Framebuffer is incomplete (" << status << ")" << std::endl;
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+Framebuffer::~Framebuffer()
+{
+    GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glDeleteRenderbuffers(1, &m_ColorAttachment));
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void Framebuffer::Bind() const
+{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+bool Framebuffer::SaveColorAttachment(const std::string &path) const
+{
+    std::vector<unsigned char> pixels(m_Width * m_Height * 3);
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data()));
+
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream)
+        return false;
+    stream << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+    for (int y = m_Height - 1; y >= 0; --y) // OpenGL rows start at the bottom
+        stream.write((const char *)&pixels[y * m_Width * 3], m_Width * 3);
+    return (bool)stream;
+}
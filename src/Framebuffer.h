@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Offscreen render target (RGBA8 color + depth/stencil renderbuffers),
+ * used when there is no window to draw into.
+ */
+class Framebuffer
+{
+private:
+    uint m_RendererID;
+    uint m_ColorAttachment;
+    uint m_DepthAttachment;
+    int m_Width, m_Height;
+
+public:
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    void Bind() const;
+    void Unbind() const { GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0)); }
+
+    // Write the color attachment as a binary PPM image
+    bool SaveColorAttachment(const std::string &path) const;
+
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+};
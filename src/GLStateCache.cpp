@@ -0,0 +1,302 @@
+#include "GLStateCache.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+GLStateCache &GLStateCache::Get()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+/*
+ * Returns true (and records the new value) when the call has to be issued
+ */
+bool GLStateCache::Update(uint &cached, uint value)
+{
+    if (cached == value)
+    {
+        m_Stats.Skipped++;
+        return false;
+    }
+    cached = value;
+    m_Stats.Issued++;
+    return true;
+}
+
+int GLStateCache::BufferTargetIndex(uint target)
+{
+    switch (target)
+    {
+    case GL_ARRAY_BUFFER:
+        return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return 1;
+    case GL_UNIFORM_BUFFER:
+        return 2;
+    case GL_PIXEL_UNPACK_BUFFER:
+        return 3;
+    case GL_COPY_WRITE_BUFFER:
+        return 4;
+    }
+    return -1;
+}
+
+int GLStateCache::TextureTargetIndex(uint target)
+{
+    switch (target)
+    {
+    case GL_TEXTURE_2D:
+        return 0;
+    case GL_TEXTURE_2D_ARRAY:
+        return 1;
+    }
+    return -1;
+}
+
+int GLStateCache::CapabilityIndex(uint capability)
+{
+    switch (capability)
+    {
+    case GL_BLEND:
+        return 0;
+    case GL_DEPTH_TEST:
+        return 1;
+    case GL_CULL_FACE:
+        return 2;
+    case GL_SCISSOR_TEST:
+        return 3;
+    }
+    return -1;
+}
+
+void GLStateCache::UseProgram(uint program)
+{
+    if (Update(m_Program, program))
+    {
+        GLCall(glUseProgram(program));
+    }
+}
+
+void GLStateCache::BindVertexArray(uint vertexArray)
+{
+    if (Update(m_VertexArray, vertexArray))
+    {
+        GLCall(glBindVertexArray(vertexArray));
+        // The element array binding is part of the vertex array state
+        m_Buffers[BufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+}
+
+void GLStateCache::BindBuffer(uint target, uint buffer)
+{
+    int index = BufferTargetIndex(target);
+    if (index < 0)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindBuffer(target, buffer));
+    }
+    else if (Update(m_Buffers[index], buffer))
+    {
+        GLCall(glBindBuffer(target, buffer));
+    }
+}
+
+void GLStateCache::BindBufferBase(uint target, uint index, uint buffer)
+{
+    BindBufferRange(target, index, buffer, 0, 0);
+}
+
+void GLStateCache::BindBufferRange(uint target, uint index, uint buffer, uint offset, uint size)
+{
+    if (target == GL_UNIFORM_BUFFER && index < MaxUniformBindings)
+    {
+        BufferRange &bound = m_UniformBindings[index];
+        if (bound.Buffer == buffer && bound.Offset == offset && bound.Size == size)
+        {
+            m_Stats.Skipped++;
+            return;
+        }
+        bound = {buffer, offset, size};
+    }
+    m_Stats.Issued++;
+    if (size == 0)
+    {
+        GLCall(glBindBufferBase(target, index, buffer));
+    }
+    else
+    {
+        GLCall(glBindBufferRange(target, index, buffer, offset, size));
+    }
+    int generic = BufferTargetIndex(target);
+    if (generic >= 0)
+        m_Buffers[generic] = buffer;
+}
+
+void GLStateCache::ActiveTexture(uint unit)
+{
+    if (Update(m_ActiveTexture, unit))
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+    }
+}
+
+void GLStateCache::BindTexture(uint target, uint texture)
+{
+    int index = TextureTargetIndex(target);
+    if (index < 0 || m_ActiveTexture >= MaxTextureUnits)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindTexture(target, texture));
+    }
+    else if (Update(m_Textures[m_ActiveTexture][index], texture))
+    {
+        GLCall(glBindTexture(target, texture));
+    }
+}
+
+void GLStateCache::BindTexture(uint unit, uint target, uint texture)
+{
+    /* Avoid switching the active unit when the texture is already bound there */
+    int index = TextureTargetIndex(target);
+    if (index >= 0 && unit < MaxTextureUnits && m_Textures[unit][index] == texture)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+    ActiveTexture(unit);
+    BindTexture(target, texture);
+}
+
+void GLStateCache::BindSampler(uint unit, uint sampler)
+{
+    /* Sampler bindings are per unit, glActiveTexture does not matter */
+    if (unit >= MaxTextureUnits)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindSampler(unit, sampler));
+    }
+    else if (Update(m_Samplers[unit], sampler))
+    {
+        GLCall(glBindSampler(unit, sampler));
+    }
+}
+
+void GLStateCache::Enable(uint capability)
+{
+    int index = CapabilityIndex(capability);
+    if (index < 0)
+    {
+        m_Stats.Issued++;
+        GLCall(glEnable(capability));
+    }
+    else if (Update(m_Capabilities[index], 1))
+    {
+        GLCall(glEnable(capability));
+    }
+}
+
+void GLStateCache::Disable(uint capability)
+{
+    int index = CapabilityIndex(capability);
+    if (index < 0)
+    {
+        m_Stats.Issued++;
+        GLCall(glDisable(capability));
+    }
+    else if (Update(m_Capabilities[index], 0))
+    {
+        GLCall(glDisable(capability));
+    }
+}
+
+void GLStateCache::BlendFunc(uint src, uint dst)
+{
+    if (m_BlendSrc == src && m_BlendDst == dst)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+    m_BlendSrc = src;
+    m_BlendDst = dst;
+    m_Stats.Issued++;
+    GLCall(glBlendFunc(src, dst));
+}
+
+void GLStateCache::DepthFunc(uint func)
+{
+    if (Update(m_DepthFunc, func))
+    {
+        GLCall(glDepthFunc(func));
+    }
+}
+
+void GLStateCache::DepthMask(bool enabled)
+{
+    if (Update(m_DepthMask, enabled))
+    {
+        GLCall(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+    }
+}
+
+void GLStateCache::DeleteProgram(uint program)
+{
+    if (m_Program == program)
+        m_Program = Unknown;
+    GLCall(glDeleteProgram(program));
+}
+
+void GLStateCache::DeleteVertexArray(uint vertexArray)
+{
+    if (m_VertexArray == vertexArray)
+    {
+        m_VertexArray = Unknown;
+        m_Buffers[BufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+    GLCall(glDeleteVertexArrays(1, &vertexArray));
+}
+
+void GLStateCache::DeleteBuffer(uint buffer)
+{
+    for (uint &bound : m_Buffers)
+        if (bound == buffer)
+            bound = Unknown;
+    for (BufferRange &bound : m_UniformBindings)
+        if (bound.Buffer == buffer)
+            bound = {Unknown, 0, 0};
+    GLCall(glDeleteBuffers(1, &buffer));
+}
+
+void GLStateCache::DeleteTexture(uint texture)
+{
+    for (auto &unit : m_Textures)
+        for (uint &bound : unit)
+            if (bound == texture)
+                bound = Unknown;
+    GLCall(glDeleteTextures(1, &texture));
+}
+
+void GLStateCache::DeleteSampler(uint sampler)
+{
+    for (uint &bound : m_Samplers)
+        if (bound == sampler)
+            bound = Unknown;
+    GLCall(glDeleteSamplers(1, &sampler));
+}
+
+void GLStateCache::Invalidate()
+{
+    m_Program = Unknown;
+    m_VertexArray = Unknown;
+    m_Buffers.fill(Unknown);
+    m_UniformBindings.fill({Unknown, 0, 0});
+    m_ActiveTexture = Unknown;
+    for (auto &unit : m_Textures)
+        unit.fill(Unknown);
+    m_Samplers.fill(Unknown);
+    m_Capabilities.fill(Unknown);
+    m_BlendSrc = m_BlendDst = Unknown;
+    m_DepthFunc = Unknown;
+    m_DepthMask = Unknown;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Shadows the bind/use state of the (single) OpenGL context and skips calls
+ * that would not change anything. Everything that binds GL objects should go
+ * through here, otherwise the cache goes stale; code we don't own (ImGui)
+ * must be followed by Invalidate().
+ */
+class GLStateCache
+{
+public:
+    struct Stats
+    {
+        uint Issued = 0;  // Calls forwarded to the driver
+        uint Skipped = 0; // Redundant calls that were dropped
+    };
+
+    static constexpr uint MaxTextureUnits = 32;
+    static constexpr uint MaxUniformBindings = 16;
+
+private:
+    static constexpr uint Unknown = ~0u;
+    static constexpr uint BufferTargetCount = 5;
+    static constexpr uint TextureTargetCount = 2;
+    static constexpr uint CapabilityCount = 4;
+
+    uint m_Program;
+    uint m_VertexArray;
+    std::array<uint, BufferTargetCount> m_Buffers;
+    struct BufferRange
+    {
+        uint Buffer, Offset, Size; // Size 0 means the whole buffer
+    };
+    std::array<BufferRange, MaxUniformBindings> m_UniformBindings;
+    uint m_ActiveTexture;
+    std::array<std::array<uint, TextureTargetCount>, MaxTextureUnits> m_Textures;
+    std::array<uint, MaxTextureUnits> m_Samplers;
+    std::array<uint, CapabilityCount> m_Capabilities; // 0, 1 or Unknown
+    uint m_BlendSrc, m_BlendDst;
+    uint m_DepthFunc;
+    uint m_DepthMask;
+    Stats m_Stats;
+
+    GLStateCache() { Invalidate(); }
+
+public:
+    static GLStateCache &Get();
+
+    void UseProgram(uint program);
+    void BindVertexArray(uint vertexArray);
+    void BindBuffer(uint target, uint buffer);
+    // Indexed GL_UNIFORM_BUFFER bindings (these also change the generic binding)
+    void BindBufferBase(uint target, uint index, uint buffer);
+    void BindBufferRange(uint target, uint index, uint buffer, uint offset, uint size);
+    void ActiveTexture(uint unit); // Unit index, not GL_TEXTURE0 + unit
+    void BindTexture(uint target, uint texture);
+    void BindTexture(uint unit, uint target, uint texture);
+    void BindSampler(uint unit, uint sampler); // 0 goes back to the texture's own parameters
+
+    void Enable(uint capability);
+    void Disable(uint capability);
+    void BlendFunc(uint src, uint dst);
+    void DepthFunc(uint func);
+    void DepthMask(bool enabled);
+
+    // Deleting a bound object implicitly unbinds it
+    void DeleteProgram(uint program);
+    void DeleteVertexArray(uint vertexArray);
+    void DeleteBuffer(uint buffer);
+    void DeleteTexture(uint texture);
+    void DeleteSampler(uint sampler);
+
+    // Forget everything, e.g. after code outside our control changed GL state
+    void Invalidate();
+
+    inline uint GetProgram() const { return m_Program; }
+    inline const Stats &GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats = Stats(); }
+
+private:
+    bool Update(uint &cached, uint value);
+    static int BufferTargetIndex(uint target);
+    static int TextureTargetIndex(uint target);
+    static int CapabilityIndex(uint capability);
+};
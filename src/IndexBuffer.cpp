@@ -0,0 +1,42 @@
+#include "IndexBuffer.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+IndexBuffer::IndexBuffer(const uint *data, uint count) : m_Count(count)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));                      // Generate Index buffer ID
+    Bind();                                                       // Assign buffer type Array
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint), data, GL_STATIC_DRAW));
+}
+
+IndexBuffer::IndexBuffer(uint count, BufferMode mode) : m_Count(count)
+{
+    if (mode == BufferMode::Stream)
+    {
+        m_Stream = std::make_unique<StreamingBuffer>(count * sizeof(uint));
+        m_RendererID = m_Stream->GetRendererID();
+        return;
+    }
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Bind();
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint), nullptr, GL_DYNAMIC_DRAW));
+}
+
+IndexBuffer::~IndexBuffer()
+{
+    if (!m_Stream) // The stream owns its buffer
+        GLStateCache::Get().DeleteBuffer(m_RendererID);
+}
+
+uint *IndexBuffer::Map(uint count)
+{
+    ASSERT(m_Stream);
+    return (uint *)m_Stream->Map(count * sizeof(uint), sizeof(uint));
+}
+
+void IndexBuffer::Unmap()
+{
+    m_Stream->Unmap();
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+
 #include "Util.h"
+#include "GLStateCache.h"
+#include "StreamingBuffer.h"
 
 // ============================================================================
 // Class definition
@@ -11,24 +15,21 @@ class IndexBuffer
 private:
     uint m_RendererID;
     uint m_Count;
+    std::unique_ptr<StreamingBuffer> m_Stream; // Only in BufferMode::Stream
 
 public:
     IndexBuffer(const uint *data, uint count);
-    ~IndexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+    // Stream mode: count is the per-region capacity, written through Map/Unmap
+    IndexBuffer(uint count, BufferMode mode);
+    ~IndexBuffer();
 
-    void Bind() const { GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID)); }
-    void Unbind() const { GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0)); }
+    void Bind() const { GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID); }
+    void Unbind() const { GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); }
 
     inline uint GetCount() const { return m_Count; }
-};
 
-// ============================================================================
-// Implementation
-// ============================================================================
-
-IndexBuffer::IndexBuffer(const uint *data, uint count) : m_Count(count)
-{
-    GLCall(glGenBuffers(1, &m_RendererID));                      // Generate Index buffer ID
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID)); // Assign buffer type Array
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint), data, GL_STATIC_DRAW));
-}
\ No newline at end of file
+    // Stream mode only, the first written index is GetStreamOffset() / sizeof(uint)
+    uint *Map(uint count);
+    void Unmap();
+    inline uint GetStreamOffset() const { return m_Stream ? m_Stream->GetMappedOffset() : 0; }
+};
@@ -0,0 +1,171 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+thread_local uint JobSystem::s_ThreadIndex = 0;
+
+JobSystem::JobSystem() : m_Queued(0), m_Sleeping(0), m_Stopping(false), m_Executed(0), m_Stolen(0)
+{
+    StartWorkers(0);
+}
+
+JobSystem &JobSystem::Get()
+{
+    static JobSystem instance;
+    return instance;
+}
+
+void JobSystem::SetThreadCount(uint count)
+{
+    StopWorkers();
+    StartWorkers(count);
+}
+
+void JobSystem::StartWorkers(uint count)
+{
+    if (count == 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+    m_Stopping = false;
+    m_Queues.clear();
+    for (uint i = 0; i < count; ++i)
+        m_Queues.push_back(std::make_unique<Queue>());
+    for (uint i = 1; i < count; ++i)
+        m_Workers.emplace_back(&JobSystem::WorkerMain, this, i);
+}
+
+void JobSystem::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stopping = true;
+    }
+    m_Wake.notify_all();
+    for (std::thread &worker : m_Workers)
+        worker.join();
+    m_Workers.clear();
+}
+
+void JobSystem::Run(JobCounter &counter, Job job)
+{
+    counter.Pending.fetch_add(1, std::memory_order_relaxed);
+    Queue &queue = *m_Queues[s_ThreadIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Tasks.push_back({std::move(job), &counter});
+    }
+    m_Queued.fetch_add(1);
+
+    /*
+     * A worker going to sleep increments m_Sleeping before it checks
+     * m_Queued, so either it sees this job or we see it sleeping. The lock
+     * makes sure it is actually waiting before the notify.
+     */
+    if (m_Sleeping.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_Wake.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    uint index = s_ThreadIndex;
+    while (!counter.IsDone())
+        if (!RunOne(index))
+            std::this_thread::yield();
+}
+
+void JobSystem::ParallelFor(uint count, uint grain, const std::function<void(uint, uint, uint)> &function)
+{
+    grain = std::max(1u, grain);
+    JobCounter counter;
+    uint chunk = 0;
+    for (uint begin = 0; begin < count; begin += grain, ++chunk)
+    {
+        uint end = std::min(count, begin + grain);
+        Run(counter, [&function, begin, end, chunk]() { function(begin, end, chunk); });
+    }
+    Wait(counter);
+}
+
+void JobSystem::WorkerMain(uint index)
+{
+    s_ThreadIndex = index;
+    while (true)
+    {
+        if (RunOne(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleeping.fetch_add(1);
+        m_Wake.wait(lock, [this]() { return m_Stopping || m_Queued.load() > 0; });
+        m_Sleeping.fetch_sub(1);
+        if (m_Stopping)
+            return;
+    }
+}
+
+bool JobSystem::RunOne(uint index)
+{
+    Task task;
+    bool found = false;
+
+    /* Newest own job first */
+    {
+        Queue &queue = *m_Queues[index];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (!queue.Tasks.empty())
+        {
+            task = std::move(queue.Tasks.back());
+            queue.Tasks.pop_back();
+            found = true;
+        }
+    }
+
+    /* Oldest job of someone else, starting with the next thread so thieves spread out */
+    for (uint i = 1; !found && i < m_Queues.size(); ++i)
+    {
+        Queue &queue = *m_Queues[(index + i) % m_Queues.size()];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (!queue.Tasks.empty())
+        {
+            task = std::move(queue.Tasks.front());
+            queue.Tasks.pop_front();
+            found = true;
+            m_Stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!found)
+        return false;
+    m_Queued.fetch_sub(1);
+    Execute(task);
+    return true;
+}
+
+void JobSystem::Execute(Task &task)
+{
+    task.Function();
+    m_Executed.fetch_add(1, std::memory_order_relaxed);
+    task.Counter->Pending.fetch_sub(1, std::memory_order_release);
+}
+
+JobSystem::Stats JobSystem::GetStats() const
+{
+    Stats stats;
+    stats.Executed = m_Executed.load(std::memory_order_relaxed);
+    stats.Stolen = m_Stolen.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::ResetStats()
+{
+    m_Executed = 0;
+    m_Stolen = 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+// Counts the jobs of one batch that have not finished, see JobSystem::Wait()
+struct JobCounter
+{
+    std::atomic<uint> Pending{0};
+
+    inline bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+};
+
+/*
+ * One worker per core next to the calling (main) thread, each with its own
+ * deque. Threads push and pop their own jobs at the back (the most recent,
+ * still in cache) and steal from the front of the others when they run dry.
+ * Waiting threads run jobs instead of blocking, so jobs may start and wait
+ * for other jobs. Idle workers sleep until something is pushed.
+ *
+ * Jobs must not touch OpenGL, only the main thread has a context.
+ */
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    struct Stats
+    {
+        uint Executed = 0;
+        uint Stolen = 0; // Executed by another thread than the one that pushed them
+    };
+
+private:
+    struct Task
+    {
+        Job Function;
+        JobCounter *Counter;
+    };
+    struct Queue
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_Queues; // Index 0 is the main thread
+    std::vector<std::thread> m_Workers;
+    std::atomic<uint> m_Queued;   // Tasks in all queues
+    std::atomic<uint> m_Sleeping; // Workers waiting on m_Wake
+    std::mutex m_SleepMutex;
+    std::condition_variable m_Wake;
+    bool m_Stopping; // Guarded by m_SleepMutex
+    std::atomic<uint> m_Executed, m_Stolen;
+
+    static thread_local uint s_ThreadIndex;
+
+    JobSystem();
+    ~JobSystem() { StopWorkers(); }
+
+public:
+    static JobSystem &Get();
+
+    // Including the main thread; 0 picks the hardware threads. Only while idle.
+    void SetThreadCount(uint count);
+    inline uint GetThreadCount() const { return m_Queues.size(); }
+    // 0 on the main thread (or any thread outside the system), 1.. on workers
+    static inline uint GetThreadIndex() { return s_ThreadIndex; }
+
+    void Run(JobCounter &counter, Job job);
+    // Runs queued jobs until every job counted by counter finished
+    void Wait(JobCounter &counter);
+    // Splits [0, count) into chunks of up to grain and waits for all of them;
+    // function(begin, end, chunk) gets the chunk index for per-chunk output
+    void ParallelFor(uint count, uint grain, const std::function<void(uint, uint, uint)> &function);
+
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    void StartWorkers(uint count);
+    void StopWorkers();
+    void WorkerMain(uint index);
+    bool RunOne(uint index); // Returns false if every queue was empty
+    void Execute(Task &task);
+};
@@ -0,0 +1,138 @@
+#include "KtxFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    const unsigned char s_Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    const uint32_t s_Endianness = 0x04030201;
+    const char s_Orientation[] = "KTXorientation\0S=r,T=u"; // Key and value, both null terminated
+
+    struct Header
+    {
+        unsigned char Identifier[12];
+        uint32_t Endianness;
+        uint32_t Type;
+        uint32_t TypeSize;
+        uint32_t Format;
+        uint32_t InternalFormat;
+        uint32_t BaseInternalFormat;
+        uint32_t PixelWidth;
+        uint32_t PixelHeight;
+        uint32_t PixelDepth;
+        uint32_t ArrayElements;
+        uint32_t Faces;
+        uint32_t MipmapLevels;
+        uint32_t KeyValueBytes;
+    };
+
+    size_t Pad4(size_t size)
+    {
+        return (size + 3) & ~(size_t)3;
+    }
+}
+
+KtxFile::KtxFile() : m_Type(0), m_Format(0), m_InternalFormat(0), m_Width(0), m_Height(0)
+{
+}
+
+bool KtxFile::Parse(const unsigned char *data, size_t size, std::string &error)
+{
+    m_Levels.clear();
+    Header header;
+    if (size < sizeof(header))
+    {
+        error = "file too small";
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.Identifier, s_Identifier, sizeof(s_Identifier)) != 0)
+    {
+        error = "not a KTX 1.1 file";
+        return false;
+    }
+    if (header.Endianness != s_Endianness)
+    {
+        error = "byte swapped files are not supported";
+        return false;
+    }
+    if (header.PixelHeight == 0 || header.PixelDepth > 1 || header.ArrayElements > 0 || header.Faces != 1)
+    {
+        error = "only single 2D images are supported";
+        return false;
+    }
+
+    m_Type = header.Type;
+    m_Format = header.Format;
+    m_InternalFormat = header.InternalFormat;
+    m_Width = header.PixelWidth;
+    m_Height = header.PixelHeight;
+
+    /* Each level: imageSize, the image, padding to 4 bytes */
+    size_t offset = sizeof(header) + header.KeyValueBytes;
+    uint32_t levels = header.MipmapLevels ? header.MipmapLevels : 1; // 0 asks for glGenerateMipmap
+    for (uint32_t level = 0; level < levels; ++level)
+    {
+        uint32_t imageSize;
+        if (offset + sizeof(imageSize) > size)
+            break;
+        memcpy(&imageSize, data + offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+        if (imageSize > size - offset)
+            break;
+        m_Levels.push_back({data + offset, imageSize, std::max(1, m_Width >> level), std::max(1, m_Height >> level)});
+        offset += Pad4(imageSize);
+    }
+    if (m_Levels.size() != levels)
+    {
+        error = "truncated file";
+        m_Levels.clear();
+        return false;
+    }
+    return true;
+}
+
+bool KtxFile::Write(const std::string &path, uint32_t type, uint32_t format, uint32_t internalFormat,
+                    uint32_t baseInternalFormat, int width, int height,
+                    const std::vector<std::vector<unsigned char>> &levels)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    uint32_t keyValueSize = sizeof(s_Orientation);
+    Header header = {};
+    memcpy(header.Identifier, s_Identifier, sizeof(s_Identifier));
+    header.Endianness = s_Endianness;
+    header.Type = type;
+    header.TypeSize = 1;
+    header.Format = format;
+    header.InternalFormat = internalFormat;
+    header.BaseInternalFormat = baseInternalFormat;
+    header.PixelWidth = width;
+    header.PixelHeight = height;
+    header.Faces = 1;
+    header.MipmapLevels = levels.size();
+    header.KeyValueBytes = Pad4(sizeof(keyValueSize) + keyValueSize);
+
+    const unsigned char zeros[4] = {};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(&keyValueSize, sizeof(keyValueSize), 1, file) == 1 &&
+              fwrite(s_Orientation, 1, keyValueSize, file) == keyValueSize &&
+              fwrite(zeros, 1, header.KeyValueBytes - sizeof(keyValueSize) - keyValueSize, file) ==
+                  header.KeyValueBytes - sizeof(keyValueSize) - keyValueSize;
+    for (const std::vector<unsigned char> &level : levels)
+    {
+        uint32_t imageSize = level.size();
+        ok = ok && fwrite(&imageSize, sizeof(imageSize), 1, file) == 1 &&
+             fwrite(level.data(), 1, level.size(), file) == level.size() &&
+             fwrite(zeros, 1, Pad4(level.size()) - level.size(), file) == Pad4(level.size()) - level.size();
+    }
+    return fclose(file) == 0 && ok;
+}
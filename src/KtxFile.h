@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * KTX 1.1 container holding a 2D texture and its mip chain. Parse() only
+ * validates the layout and points into the caller's memory (typically a
+ * MappedFile), so the levels can be handed to glCompressedTexSubImage2D as
+ * they are. Files written by Write() store rows bottom up
+ * (KTXorientation S=r,T=u), which is what OpenGL expects.
+ */
+class KtxFile
+{
+public:
+    struct Level
+    {
+        const unsigned char *Data;
+        uint32_t Size;
+        int Width, Height;
+    };
+
+private:
+    uint32_t m_Type;   // 0 for compressed formats
+    uint32_t m_Format; // 0 for compressed formats
+    uint32_t m_InternalFormat;
+    int m_Width, m_Height;
+    std::vector<Level> m_Levels;
+
+public:
+    KtxFile();
+
+    // False (with a reason) for anything but a single 2D image with native byte order
+    bool Parse(const unsigned char *data, size_t size, std::string &error);
+    // Type and format are 0 for compressed formats
+    static bool Write(const std::string &path, uint32_t type, uint32_t format, uint32_t internalFormat,
+                      uint32_t baseInternalFormat, int width, int height,
+                      const std::vector<std::vector<unsigned char>> &levels);
+
+    inline bool IsCompressed() const { return m_Type == 0; }
+    inline uint32_t GetType() const { return m_Type; }
+    inline uint32_t GetFormat() const { return m_Format; }
+    inline uint32_t GetInternalFormat() const { return m_InternalFormat; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline const std::vector<Level> &GetLevels() const { return m_Levels; }
+};
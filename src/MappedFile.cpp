@@ -0,0 +1,36 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+MappedFile::MappedFile(const std::string &path) : m_Data(nullptr), m_Size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    /* The mapping keeps the file alive, the descriptor is not needed after this */
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            m_Data = (const unsigned char *)data;
+            m_Size = info.st_size;
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+        munmap((void *)m_Data, m_Size);
+}
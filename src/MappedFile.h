@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Read-only memory map of a whole file. Pages are faulted in on first
+ * access, so parsing a header never reads the rest of the file, and data
+ * can go to the driver without a copy into a heap buffer first.
+ */
+class MappedFile
+{
+private:
+    const unsigned char *m_Data;
+    size_t m_Size;
+
+public:
+    MappedFile(const std::string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    inline bool IsValid() const { return m_Data != nullptr; }
+    inline const unsigned char *GetData() const { return m_Data; }
+    inline size_t GetSize() const { return m_Size; }
+};
@@ -0,0 +1,94 @@
+#include "Mipmap.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+int Mipmap::GetLevelCount(int width, int height)
+{
+    int levels = 1;
+    for (int size = std::max(width, height); size > 1; size >>= 1)
+        levels++;
+    return levels;
+}
+
+void Mipmap::DownsampleRows(const unsigned char *source, int width, int height, unsigned char *destination,
+                            int firstColumn, int y)
+{
+    int outWidth = GetLevelSize(width, 1);
+    const unsigned char *row0 = source + (size_t)std::min(2 * y, height - 1) * width * 4;
+    const unsigned char *row1 = source + (size_t)std::min(2 * y + 1, height - 1) * width * 4;
+    unsigned char *out = destination + (size_t)y * outWidth * 4;
+    for (int x = firstColumn; x < outWidth; ++x)
+    {
+        int x0 = std::min(2 * x, width - 1) * 4, x1 = std::min(2 * x + 1, width - 1) * 4;
+        for (int c = 0; c < 4; ++c)
+            out[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2;
+    }
+}
+
+void Mipmap::DownsampleScalar(const unsigned char *source, int width, int height, unsigned char *destination)
+{
+    for (int y = 0; y < GetLevelSize(height, 1); ++y)
+        DownsampleRows(source, width, height, destination, 0, y);
+}
+
+void Mipmap::Downsample(const unsigned char *source, int width, int height, unsigned char *destination)
+{
+#if defined(__SSE2__)
+    int outWidth = GetLevelSize(width, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(2);
+    for (int y = 0; y < GetLevelSize(height, 1); ++y)
+    {
+        const unsigned char *row0 = source + (size_t)std::min(2 * y, height - 1) * width * 4;
+        const unsigned char *row1 = source + (size_t)std::min(2 * y + 1, height - 1) * width * 4;
+        unsigned char *out = destination + (size_t)y * outWidth * 4;
+
+        /* 4 source pixels per row -> 2 output pixels, summed in 16 bit lanes */
+        int x = 0;
+        for (; x + 2 <= outWidth && 2 * x + 4 <= width; x += 2)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *)(row0 + x * 8));
+            __m128i b = _mm_loadu_si128((const __m128i *)(row1 + x * 8));
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            low = _mm_add_epi16(low, _mm_srli_si128(low, 8));    // Pixel 0 + pixel 1 in the low half
+            high = _mm_add_epi16(high, _mm_srli_si128(high, 8)); // Pixel 2 + pixel 3
+            __m128i sum = _mm_unpacklo_epi64(low, high);
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+            _mm_storel_epi64((__m128i *)(out + x * 4), _mm_packus_epi16(sum, sum));
+        }
+        DownsampleRows(source, width, height, destination, x, y);
+    }
+#else
+    DownsampleScalar(source, width, height, destination);
+#endif
+}
+
+std::vector<unsigned char> Mipmap::GenerateChain(const unsigned char *pixels, int width, int height,
+                                                 std::vector<size_t> &offsets)
+{
+    int levels = GetLevelCount(width, height);
+    offsets.clear();
+    size_t size = 0;
+    for (int level = 1; level < levels; ++level)
+    {
+        offsets.push_back(size);
+        size += (size_t)GetLevelSize(width, level) * GetLevelSize(height, level) * 4;
+    }
+
+    std::vector<unsigned char> chain(size);
+    const unsigned char *previous = pixels;
+    for (int level = 1; level < levels; ++level)
+    {
+        unsigned char *current = chain.data() + offsets[level - 1];
+        Downsample(previous, GetLevelSize(width, level - 1), GetLevelSize(height, level - 1), current);
+        previous = current;
+    }
+    return chain;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+enum class MipmapMode
+{
+    None, // Level 0 only
+    Gpu,  // glGenerateMipmap after the upload
+    Cpu   // Mipmap::GenerateChain, e.g. to bake levels offline
+};
+
+/*
+ * CPU side mip chain for RGBA8 images. Every level is a 2x2 box filter of
+ * the previous one (SSE2 where available). An odd last row or column is
+ * dropped, and 1 pixel wide levels only average along the other axis.
+ */
+class Mipmap
+{
+public:
+    // Levels down to 1x1, including level 0
+    static int GetLevelCount(int width, int height);
+    static inline int GetLevelSize(int size, int level) { return std::max(1, size >> level); }
+
+    // Writes the next level (GetLevelSize(width, 1) x GetLevelSize(height, 1))
+    static void Downsample(const unsigned char *source, int width, int height, unsigned char *destination);
+    static void DownsampleScalar(const unsigned char *source, int width, int height, unsigned char *destination);
+
+    // All levels after level 0, back to back; offsets[i] is where level i + 1 starts
+    static std::vector<unsigned char> GenerateChain(const unsigned char *pixels, int width, int height,
+                                                    std::vector<size_t> &offsets);
+
+private:
+    static void DownsampleRows(const unsigned char *source, int width, int height, unsigned char *destination,
+                               int firstColumn, int y);
+};
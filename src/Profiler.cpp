@@ -0,0 +1,225 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+
+#include "vendor/imgui/imgui.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+Profiler::Profiler() : m_Enabled(false), m_Active(false), m_Epoch(std::chrono::steady_clock::now()), m_FrameIndex(0)
+{
+}
+
+Profiler &Profiler::Get()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+double Profiler::CpuMs(std::chrono::steady_clock::time_point start) const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Profiler::BeginFrame()
+{
+    m_FrameIndex = (m_FrameIndex + 1) % FrameLatency;
+    PendingFrame &frame = m_Frames[m_FrameIndex];
+    if (frame.Pending) // Recorded FrameLatency frames ago
+        Resolve(frame);
+
+    m_Active = m_Enabled;
+    m_Stack.clear();
+    frame.Data.Scopes.clear();
+    frame.Start = std::chrono::steady_clock::now();
+    frame.Data.CpuStartMs = std::chrono::duration<double, std::milli>(frame.Start - m_Epoch).count();
+}
+
+void Profiler::EndFrame()
+{
+    PendingFrame &frame = m_Frames[m_FrameIndex];
+    frame.Pending = m_Active && !frame.Data.Scopes.empty();
+    m_Active = false;
+    m_Stack.clear();
+}
+
+void Profiler::BeginScope(const char *name)
+{
+    if (!m_Active)
+        return;
+    PendingFrame &frame = m_Frames[m_FrameIndex];
+    uint index = frame.Data.Scopes.size();
+    if (index == MaxScopes)
+    {
+        m_Stack.push_back(-1);
+        return;
+    }
+
+    if (frame.Queries.size() < 2 * (index + 1)) // Grow the query pool in chunks
+    {
+        uint count = std::max<uint>(64, frame.Queries.size());
+        frame.Queries.resize(frame.Queries.size() + count);
+        GLCall(glGenQueries(count, &frame.Queries[frame.Queries.size() - count]));
+    }
+
+    frame.Data.Scopes.push_back({name, (uint)m_Stack.size(), CpuMs(frame.Start), 0.0, -1.0, -1.0});
+    frame.LastQuery = frame.Queries[2 * index];
+    GLCall(glQueryCounter(frame.LastQuery, GL_TIMESTAMP));
+    m_Stack.push_back(index);
+}
+
+void Profiler::EndScope()
+{
+    if (!m_Active || m_Stack.empty())
+        return;
+    int index = m_Stack.back();
+    m_Stack.pop_back();
+    if (index < 0)
+        return;
+
+    PendingFrame &frame = m_Frames[m_FrameIndex];
+    frame.Data.Scopes[index].CpuEndMs = CpuMs(frame.Start);
+    frame.LastQuery = frame.Queries[2 * index + 1];
+    GLCall(glQueryCounter(frame.LastQuery, GL_TIMESTAMP));
+}
+
+void Profiler::Resolve(PendingFrame &frame)
+{
+    frame.Pending = false;
+    std::vector<Scope> &scopes = frame.Data.Scopes;
+
+    /* Queries complete in order, so the last one being available means all are */
+    int available = 0;
+    GLCall(glGetQueryObjectiv(frame.LastQuery, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available)
+        return; // GPU is too far behind: drop the frame rather than stall
+
+    std::vector<GLuint64> timestamps(2 * scopes.size());
+    for (uint i = 0; i < timestamps.size(); ++i)
+    {
+        GLCall(glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &timestamps[i]));
+    }
+
+    frame.Data.GpuStartNs = timestamps[0];
+    for (uint i = 0; i < scopes.size(); ++i)
+    {
+        scopes[i].GpuStartMs = (timestamps[2 * i] - frame.Data.GpuStartNs) / 1.0e6;
+        scopes[i].GpuEndMs = (timestamps[2 * i + 1] - frame.Data.GpuStartNs) / 1.0e6;
+    }
+
+    m_History.push_back(frame.Data);
+    if (m_History.size() > HistorySize)
+        m_History.pop_front();
+}
+
+bool Profiler::ExportChromeTrace(const std::string &path) const
+{
+    std::ofstream stream(path);
+    if (!stream || m_History.empty())
+        return false;
+
+    /* Thread 1 is the CPU timeline, thread 2 the GPU timeline (in its own clock) */
+    uint64_t gpuEpoch = m_History.front().GpuStartNs;
+    stream << "{\"traceEvents\": [\n";
+    stream << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"CPU\"}},\n";
+    stream << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"GPU\"}}";
+    for (const Frame &frame : m_History)
+    {
+        double gpuOffsetMs = (frame.GpuStartNs - gpuEpoch) / 1.0e6;
+        for (const Scope &scope : frame.Scopes)
+        {
+            stream << ",\n{\"name\": \"" << scope.Name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": "
+                   << (frame.CpuStartMs + scope.CpuStartMs) * 1000.0 << ", \"dur\": "
+                   << (scope.CpuEndMs - scope.CpuStartMs) * 1000.0 << "}";
+            stream << ",\n{\"name\": \"" << scope.Name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 2, \"ts\": "
+                   << (gpuOffsetMs + scope.GpuStartMs) * 1000.0 << ", \"dur\": "
+                   << (scope.GpuEndMs - scope.GpuStartMs) * 1000.0 << "}";
+        }
+    }
+    stream << "\n]}\n";
+    return (bool)stream;
+}
+
+void Profiler::OnImGuiRender()
+{
+    ImGui::Begin("Profiler");
+    ImGui::Checkbox("Enabled", &m_Enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace"))
+    {
+        if (ExportChromeTrace("profile_trace.json"))
+            std::cout << "Wrote profile_trace.json (open in chrome://tracing)" << std::endl;
+    }
+
+    const Frame *frame = GetLastFrame();
+    if (!frame || frame->Scopes.empty())
+    {
+        ImGui::Text("No frame resolved yet");
+        ImGui::End();
+        return;
+    }
+
+    /* Flame view: one row per depth, CPU on top and GPU below, scaled to the frame */
+    const Scope &root = frame->Scopes[0];
+    double cpuSpan = std::max(root.CpuEndMs, 1e-3), gpuSpan = std::max(root.GpuEndMs, 1e-3);
+    uint maxDepth = 0;
+    for (const Scope &scope : frame->Scopes)
+        maxDepth = std::max(maxDepth, scope.Depth);
+
+    const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    float width = ImGui::GetContentRegionAvail().x;
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    for (int gpu = 0; gpu < 2; ++gpu)
+    {
+        ImGui::Text("%s %.3f ms", gpu ? "GPU" : "CPU", gpu ? gpuSpan : cpuSpan);
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::InvisibleButton(gpu ? "##gpu" : "##cpu", ImVec2(width, rowHeight * (maxDepth + 1)));
+        for (const Scope &scope : frame->Scopes)
+        {
+            double start = gpu ? scope.GpuStartMs / gpuSpan : scope.CpuStartMs / cpuSpan;
+            double end = gpu ? scope.GpuEndMs / gpuSpan : scope.CpuEndMs / cpuSpan;
+            ImVec2 min(origin.x + (float)start * width, origin.y + scope.Depth * rowHeight);
+            ImVec2 max(origin.x + std::max((float)end * width, min.x - origin.x + 1.0f), min.y + rowHeight - 1.0f);
+            ImU32 color = ImColor::HSV(std::fmod(scope.Depth * 0.17f, 1.0f), 0.5f, 0.7f);
+            drawList->AddRectFilled(min, max, color);
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32_WHITE, scope.Name);
+            drawList->PopClipRect();
+            if (ImGui::IsMouseHoveringRect(min, max))
+                ImGui::SetTooltip("%s\nCPU %.3f ms\nGPU %.3f ms", scope.Name, scope.CpuEndMs - scope.CpuStartMs,
+                                  scope.GpuEndMs - scope.GpuStartMs);
+        }
+    }
+
+    /* Totals per scope name (Renderer::Draw shows up once per draw) */
+    std::map<std::string, std::array<double, 3>> totals; // Count, CPU, GPU
+    for (const Scope &scope : frame->Scopes)
+    {
+        std::array<double, 3> &total = totals[scope.Name];
+        total[0] += 1.0;
+        total[1] += scope.CpuEndMs - scope.CpuStartMs;
+        total[2] += scope.GpuEndMs - scope.GpuStartMs;
+    }
+    ImGui::Text("%-24s %6s %10s %10s", "Scope", "Count", "CPU (ms)", "GPU (ms)");
+    for (auto &total : totals)
+        ImGui::Text("%-24s %6.0f %10.3f %10.3f", total.first.c_str(), total.second[0], total.second[1], total.second[2]);
+    ImGui::End();
+}
+
+void Profiler::Shutdown()
+{
+    for (PendingFrame &frame : m_Frames)
+    {
+        if (!frame.Queries.empty())
+        {
+            GLCall(glDeleteQueries(frame.Queries.size(), frame.Queries.data()));
+        }
+        frame.Queries.clear();
+        frame.Pending = false;
+    }
+}
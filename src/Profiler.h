@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+/*
+ * Nested CPU + GPU scope timer. GPU times come from GL_TIMESTAMP queries
+ * (which, unlike GL_TIME_ELAPSED, may nest). Query sets rotate over
+ * FrameLatency frames and are only read once available, so the profiler
+ * never stalls the pipeline: GPU results show up a couple of frames late,
+ * and a frame whose queries are still pending when its set is reused is
+ * dropped instead of waited for.
+ */
+class Profiler
+{
+public:
+    static constexpr uint FrameLatency = 3;
+    static constexpr uint MaxScopes = 4096; // Per frame, further scopes are ignored
+    static constexpr uint HistorySize = 300; // Frames kept for the Chrome trace
+
+    struct Scope
+    {
+        const char *Name;  // Must outlive the profiler (string literals)
+        uint Depth;
+        double CpuStartMs; // Relative to the start of the frame
+        double CpuEndMs;
+        double GpuStartMs; // Relative to the first GPU timestamp of the frame, -1 if unknown
+        double GpuEndMs;
+    };
+
+    struct Frame
+    {
+        double CpuStartMs;   // Since the profiler was created
+        uint64_t GpuStartNs; // Raw GL_TIMESTAMP of the first scope
+        std::vector<Scope> Scopes;
+    };
+
+private:
+    struct PendingFrame
+    {
+        Frame Data;
+        std::chrono::steady_clock::time_point Start;
+        std::vector<uint> Queries; // Two per scope: begin and end
+        uint LastQuery = 0;        // Most recently issued, completes last
+        bool Pending = false;
+    };
+
+    bool m_Enabled;
+    bool m_Active; // m_Enabled latched at BeginFrame, so scopes stay balanced
+    std::chrono::steady_clock::time_point m_Epoch;
+    std::array<PendingFrame, FrameLatency> m_Frames;
+    uint m_FrameIndex;
+    std::vector<int> m_Stack; // Scope indices, -1 for ignored scopes
+    std::deque<Frame> m_History;
+
+    Profiler();
+
+public:
+    static Profiler &Get();
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    inline bool IsEnabled() const { return m_Enabled; }
+
+    void BeginFrame();
+    void EndFrame();
+    void BeginScope(const char *name);
+    void EndScope();
+
+    // Latest frame with GPU results, nullptr before the first one resolves
+    const Frame *GetLastFrame() const { return m_History.empty() ? nullptr : &m_History.back(); }
+    bool ExportChromeTrace(const std::string &path) const;
+    void OnImGuiRender();
+
+    // Releases the query objects, call before the context goes away
+    void Shutdown();
+
+private:
+    void Resolve(PendingFrame &frame);
+    double CpuMs(std::chrono::steady_clock::time_point start) const;
+};
+
+class ProfileScope
+{
+public:
+    ProfileScope(const char *name) { Profiler::Get().BeginScope(name); }
+    ~ProfileScope() { Profiler::Get().EndScope(); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
@@ -0,0 +1,192 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <dirent.h>
+#include <algorithm>
+#include <sys/stat.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    const uint32_t s_Magic = 0x42505347; // "GSPB"
+    const uint32_t s_Version = 1;
+
+    struct EntryHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t Key;    // Guards against hash file name clashes
+        uint32_t Format; // As returned by glGetProgramBinary
+        uint32_t Length;
+    };
+
+    uint64_t HashFnv1a64(const std::string &data, uint64_t hash = 14695981039346656037ull)
+    {
+        for (char c : data)
+            hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+        return hash;
+    }
+
+    std::string GetString(GLenum name)
+    {
+        const GLubyte *value = glGetString(name);
+        return value ? (const char *)value : "";
+    }
+}
+
+ProgramCache &ProgramCache::Get()
+{
+    static ProgramCache cache;
+    return cache;
+}
+
+ProgramCache::ProgramCache() : m_Directory(".shadercache"), m_Supported(false)
+{
+    m_DriverID = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' + GetString(GL_VERSION);
+
+    /* Some drivers expose the entry points but support no binary format */
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+    {
+        int formats = 0;
+        GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+        m_Formats.resize(formats);
+        if (formats > 0)
+        {
+            GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_Formats.data()));
+        }
+        m_Supported = formats > 0;
+    }
+}
+
+uint64_t ProgramCache::MakeKey(const std::string &source, const std::string &defines) const
+{
+    uint64_t hash = HashFnv1a64(m_DriverID);
+    hash = HashFnv1a64(defines, hash ^ 0xff);
+    return HashFnv1a64(source, hash ^ 0xff);
+}
+
+std::string ProgramCache::GetEntryPath(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+    return m_Directory + name;
+}
+
+uint ProgramCache::Load(uint64_t key)
+{
+    if (!m_Supported)
+        return 0;
+
+    std::string path = GetEntryPath(key);
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return 0;
+
+    EntryHeader header;
+    std::vector<char> binary;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.Magic == s_Magic &&
+              header.Version == s_Version && header.Key == key &&
+              std::find(m_Formats.begin(), m_Formats.end(), (int)header.Format) != m_Formats.end();
+    bool corrupt = false;
+    if (ok)
+    {
+        /* Length comes from the file, so check it against what follows the header before allocating */
+        fseek(file, 0, SEEK_END);
+        long remaining = ftell(file) - (long)sizeof(header);
+        fseek(file, sizeof(header), SEEK_SET);
+        corrupt = header.Length == 0 || remaining < 0 || header.Length > (unsigned long)remaining;
+        if (!corrupt)
+        {
+            binary.resize(header.Length);
+            corrupt = fread(binary.data(), 1, binary.size(), file) != binary.size();
+        }
+        ok = !corrupt;
+    }
+    fclose(file);
+    if (corrupt) // Truncated or damaged, it would fail the same way every start
+        remove(path.c_str());
+    if (!ok)
+        return 0;
+
+    /* The driver may reject binaries from another build even with equal strings */
+    GLCall(uint program = glCreateProgram());
+    GLCall(glProgramBinary(program, header.Format, binary.data(), header.Length));
+    int status = 0;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &status));
+    if (!status)
+    {
+        GLCall(glDeleteProgram(program));
+        m_Stats.Rejected++;
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::PrepareProgram(uint program) const
+{
+    if (m_Supported)
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+}
+
+void ProgramCache::Save(uint64_t key, uint program)
+{
+    if (!m_Supported)
+        return;
+
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    EntryHeader header = {s_Magic, s_Version, key, 0, 0};
+    std::vector<char> binary(length);
+    GLCall(glGetProgramBinary(program, length, &length, &header.Format, binary.data()));
+    header.Length = length;
+
+    /* Write to a temporary file first so a crash never leaves a torn entry */
+    mkdir(m_Directory.c_str(), 0755);
+    std::string path = GetEntryPath(key);
+    std::string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (!file)
+        return;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(binary.data(), 1, header.Length, file) == header.Length;
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        std::cout << "Warning: failed to write " << path << std::endl;
+    }
+}
+
+void ProgramCache::Clear()
+{
+    DIR *dir = opendir(m_Directory.c_str());
+    if (!dir)
+        return;
+    while (dirent *entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0)
+            remove((m_Directory + '/' + name).c_str());
+    }
+    closedir(dir);
+}
+
+void ProgramCache::RecordCompile(double ms)
+{
+    m_Stats.Compiled++;
+    m_Stats.CompileMs += ms;
+}
+
+void ProgramCache::RecordLoad(double ms)
+{
+    m_Stats.Loaded++;
+    m_Stats.LoadMs += ms;
+}
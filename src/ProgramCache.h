@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * On-disk cache of linked program binaries (glGetProgramBinary, GL 4.1 or
+ * ARB_get_program_binary) in .shadercache/. Entries are keyed by a hash of
+ * the shader source, the defines and the driver's vendor/renderer/version
+ * strings, so a driver update simply misses instead of loading stale code.
+ */
+class ProgramCache
+{
+public:
+    struct Stats
+    {
+        uint Compiled = 0;     // Programs built from source (cold)
+        double CompileMs = 0.0;
+        uint Loaded = 0;       // Programs loaded from a binary (warm)
+        double LoadMs = 0.0;
+        uint Rejected = 0;     // Binaries the driver refused, recompiled
+    };
+
+private:
+    std::string m_Directory;
+    std::string m_DriverID; // Vendor, renderer and version, part of every key
+    std::vector<int> m_Formats;
+    bool m_Supported;
+    Stats m_Stats;
+
+    ProgramCache();
+
+public:
+    static ProgramCache &Get();
+
+    inline bool IsSupported() const { return m_Supported; }
+    uint64_t MakeKey(const std::string &source, const std::string &defines) const;
+
+    // Returns a linked program, or 0 if there is no usable entry
+    uint Load(uint64_t key);
+    // Call before glLinkProgram so the driver keeps the binary around
+    void PrepareProgram(uint program) const;
+    void Save(uint64_t key, uint program);
+    // Removes every cached binary, the next start is cold again
+    void Clear();
+
+    void RecordCompile(double ms);
+    void RecordLoad(double ms);
+    inline const Stats &GetStats() const { return m_Stats; }
+
+private:
+    std::string GetEntryPath(uint64_t key) const;
+};
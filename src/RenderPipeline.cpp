@@ -0,0 +1,158 @@
+#include "RenderPipeline.h"
+
+#include <GLFW/glfw3.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    double MillisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Exponential moving average, a couple of dozen frames
+    void Average(double &average, double sample)
+    {
+        average += 0.05 * (sample - average);
+    }
+}
+
+RenderPipeline::RenderPipeline(GLFWwindow *window) : m_Window(window), m_Running(false), m_Stopping(false)
+{
+}
+
+RenderPipeline::~RenderPipeline()
+{
+    Stop();
+    for (Slot &slot : m_Slots)
+        ReleaseDrawData(slot);
+}
+
+void RenderPipeline::Start(RenderFunction render)
+{
+    if (m_Running)
+        return;
+    m_Render = std::move(render);
+    m_Stopping = false;
+    m_Stats = Stats();
+    for (Slot &slot : m_Slots)
+        slot.State = SlotState::Free;
+    m_Queue.clear();
+
+    glfwMakeContextCurrent(nullptr);
+    m_Thread = std::thread(&RenderPipeline::RenderMain, this);
+    m_Running = true;
+}
+
+void RenderPipeline::Stop()
+{
+    if (!m_Running)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+    m_Running = false;
+    glfwMakeContextCurrent(m_Window);
+}
+
+uint RenderPipeline::BeginFrame()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    uint index = SlotCount;
+    m_Condition.wait(lock, [this, &index]() {
+        for (uint i = 0; i < SlotCount; ++i)
+            if (m_Slots[i].State == SlotState::Free)
+            {
+                index = i;
+                return true;
+            }
+        return false;
+    });
+
+    Slot &slot = m_Slots[index];
+    slot.State = SlotState::Filling;
+    slot.Begin = std::chrono::steady_clock::now();
+    Average(m_Stats.WaitMs, MillisecondsBetween(start, slot.Begin));
+    return index;
+}
+
+void RenderPipeline::CaptureImGui(uint index)
+{
+    /* The draw lists belong to ImGui and are rebuilt by the next NewFrame(), so clone them */
+    Slot &slot = m_Slots[index];
+    ReleaseDrawData(slot);
+    ImDrawData *source = ImGui::GetDrawData();
+    if (!source)
+        return;
+    slot.DrawData = *source;
+    for (int i = 0; i < source->CmdListsCount; ++i)
+        slot.Lists.push_back(source->CmdLists[i]->CloneOutput());
+    slot.DrawData.CmdLists = slot.Lists.data();
+}
+
+void RenderPipeline::SubmitFrame(uint index)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Slot &slot = m_Slots[index];
+        slot.State = SlotState::Queued;
+        Average(m_Stats.SimulateMs, MillisecondsBetween(slot.Begin, std::chrono::steady_clock::now()));
+        m_Queue.push_back(index);
+    }
+    m_Condition.notify_all();
+}
+
+RenderPipeline::Stats RenderPipeline::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void RenderPipeline::RenderMain()
+{
+    glfwMakeContextCurrent(m_Window);
+    while (true)
+    {
+        uint index;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_Stopping || !m_Queue.empty(); });
+            if (m_Queue.empty())
+                break; // Stopping, and everything queued was drawn
+            index = m_Queue.front();
+            m_Queue.pop_front();
+            m_Slots[index].State = SlotState::Drawing;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_Render(index);
+        glfwSwapBuffers(m_Window);
+        auto end = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            Slot &slot = m_Slots[index];
+            slot.State = SlotState::Free;
+            Average(m_Stats.RenderMs, MillisecondsBetween(start, end));
+            Average(m_Stats.LatencyMs, MillisecondsBetween(slot.Begin, end));
+            m_Stats.Frames++;
+        }
+        m_Condition.notify_all();
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderPipeline::ReleaseDrawData(Slot &slot)
+{
+    for (ImDrawList *list : slot.Lists)
+        IM_DELETE(list);
+    slot.Lists.clear();
+    slot.DrawData.Clear();
+}
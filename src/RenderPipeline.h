@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Util.h"
+#include "vendor/imgui/imgui.h"
+
+struct GLFWwindow;
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Optional two stage frame pipeline. While it runs, a render thread owns the
+ * GL context and draws frame N while the main thread simulates frame N+1.
+ * The main thread takes one of SlotCount frame slots with BeginFrame(),
+ * fills it (test snapshot, ImGui draw data) and queues it with
+ * SubmitFrame(). The render thread calls the render function with the
+ * slot and presents.
+ *
+ * With three slots, one is being filled, one is queued and one is being
+ * drawn. BeginFrame() blocks when none is free, which bounds latency to
+ * two frames.
+ *
+ * Anything that touches GL on the main thread (creating or deleting a test,
+ * the profiler's queries) needs Stop() first. Stop() draws the queued frames
+ * and hands the context back.
+ */
+class RenderPipeline
+{
+public:
+    static constexpr uint SlotCount = 3;
+    using RenderFunction = std::function<void(uint slot)>;
+
+    // Moving averages, in ms
+    struct Stats
+    {
+        double LatencyMs = 0.0;  // From BeginFrame() until the frame was presented
+        double SimulateMs = 0.0; // Main thread, BeginFrame() to SubmitFrame()
+        double RenderMs = 0.0;   // Render thread, including the swap
+        double WaitMs = 0.0;     // Main thread blocked in BeginFrame()
+        uint Frames = 0;         // Presented since Start()
+    };
+
+private:
+    enum class SlotState
+    {
+        Free,
+        Filling, // Main thread
+        Queued,
+        Drawing // Render thread
+    };
+    struct Slot
+    {
+        SlotState State = SlotState::Free;
+        std::chrono::steady_clock::time_point Begin;
+        ImDrawData DrawData;             // CmdLists points into Lists
+        std::vector<ImDrawList *> Lists; // Clones, owned
+    };
+
+    GLFWwindow *m_Window;
+    RenderFunction m_Render;
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::array<Slot, SlotCount> m_Slots;
+    std::deque<uint> m_Queue; // Slots in submission order
+    bool m_Running;
+    bool m_Stopping; // Guarded by m_Mutex
+    Stats m_Stats;   // Guarded by m_Mutex
+
+public:
+    RenderPipeline(GLFWwindow *window);
+    ~RenderPipeline();
+
+    // Main thread, with the context current; releases it to the render thread
+    void Start(RenderFunction render);
+    // Draws what is queued, drops a slot being filled and takes the context back
+    void Stop();
+    inline bool IsRunning() const { return m_Running; }
+
+    // Main thread
+    uint BeginFrame();
+    // Copies ImGui::GetDrawData(), call after ImGui::Render()
+    void CaptureImGui(uint slot);
+    void SubmitFrame(uint slot);
+
+    // Render thread, the ImGui draw data captured for slot
+    ImDrawData *GetDrawData(uint slot) { return &m_Slots[slot].DrawData; }
+    Stats GetStats();
+
+private:
+    void RenderMain();
+    static void ReleaseDrawData(Slot &slot);
+};
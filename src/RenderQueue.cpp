@@ -0,0 +1,204 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool SameMaterial(const DrawPacket &a, const DrawPacket &b)
+    {
+        return a.Textures == b.Textures;
+    }
+}
+
+void RenderQueue::Submit(const DrawPacket &packet)
+{
+    m_Items.push_back({CreateKey(packet), (uint)m_Packets.size()});
+    m_Packets.push_back(packet);
+}
+
+void RenderQueue::Execute()
+{
+    PROFILE_SCOPE("RenderQueue::Execute");
+    m_Stats = Stats();
+    m_Stats.Packets = m_Packets.size();
+    m_Stats.Submitted = CountStateChanges();
+
+    auto start = std::chrono::steady_clock::now();
+    if (m_Sorting)
+        Sort();
+    m_Stats.SortMs = MillisecondsSince(start);
+    m_Stats.Executed = m_Sorting ? CountStateChanges() : m_Stats.Submitted;
+
+    start = std::chrono::steady_clock::now();
+    const DrawPacket *previous = nullptr;
+    for (const SortItem &item : m_Items)
+    {
+        const DrawPacket &packet = m_Packets[item.Index];
+        Draw(packet, previous);
+        previous = &packet;
+    }
+    m_Stats.ExecuteMs = MillisecondsSince(start);
+
+    /* Leave the default state behind for whoever draws next */
+    GLStateCache::Get().Disable(GL_BLEND);
+    GLStateCache::Get().DepthMask(true);
+    Clear();
+}
+
+void RenderQueue::Clear()
+{
+    m_Packets.clear();
+    m_Items.clear();
+}
+
+uint64_t RenderQueue::CreateKey(const DrawPacket &packet)
+{
+    const uint64_t idMask = (1ull << IDBits) - 1;
+    const uint64_t depthMax = (1ull << DepthBits) - 1;
+    uint64_t shader = GetShaderID(packet.Program) & idMask;
+    uint64_t material = GetMaterialID(packet) & idMask;
+    uint64_t depth = (uint64_t)(std::clamp(packet.Depth, 0.0f, 1.0f) * depthMax);
+
+    uint64_t key = (uint64_t)(packet.Layer & 0xf) << 60;
+    if (!packet.Translucent)
+        return key | shader << (59 - IDBits) | material << (59 - 2 * IDBits) | depth << (59 - 2 * IDBits - DepthBits);
+    key |= 1ull << 59;
+    return key | (depthMax - depth) << (59 - DepthBits) | shader << (59 - DepthBits - IDBits) |
+           material << (59 - DepthBits - 2 * IDBits);
+}
+
+uint RenderQueue::GetShaderID(const Shader *shader)
+{
+    /* Start over rather than overflow, IDs only need to be stable within a frame */
+    if (m_ShaderIDs.size() > (1u << IDBits) && m_Packets.empty())
+        m_ShaderIDs.clear();
+    auto it = m_ShaderIDs.find(shader);
+    if (it != m_ShaderIDs.end())
+        return it->second;
+    uint id = m_ShaderIDs.size();
+    m_ShaderIDs.emplace(shader, id);
+    return id;
+}
+
+uint RenderQueue::GetMaterialID(const DrawPacket &packet)
+{
+    uint64_t hash = 14695981039346656037ull; // FNV-1a over the texture IDs
+    for (const Texture *texture : packet.Textures)
+        hash = (hash ^ (texture ? texture->GetRendererID() : 0)) * 1099511628211ull;
+
+    if (m_MaterialIDs.size() > (1u << IDBits) && m_Packets.empty())
+        m_MaterialIDs.clear();
+    auto it = m_MaterialIDs.find(hash);
+    if (it != m_MaterialIDs.end())
+        return it->second;
+    uint id = m_MaterialIDs.size();
+    m_MaterialIDs.emplace(hash, id);
+    return id;
+}
+
+void RenderQueue::Sort()
+{
+    /* All eight byte histograms in one pass over the keys */
+    const size_t count = m_Items.size();
+    std::array<std::array<uint, 256>, 8> histograms{};
+    for (const SortItem &item : m_Items)
+        for (uint digit = 0; digit < 8; ++digit)
+            histograms[digit][(item.Key >> (digit * 8)) & 0xff]++;
+
+    m_Scratch.resize(count);
+    SortItem *source = m_Items.data();
+    SortItem *target = m_Scratch.data();
+    for (uint digit = 0; digit < 8; ++digit)
+    {
+        std::array<uint, 256> &offsets = histograms[digit];
+        uint shift = digit * 8;
+        /* Every key has the same byte here (e.g. unused layers), nothing to do */
+        if (count == 0 || offsets[(source[0].Key >> shift) & 0xff] == count)
+            continue;
+
+        uint sum = 0;
+        for (uint &offset : offsets)
+        {
+            uint bucket = offset;
+            offset = sum;
+            sum += bucket;
+        }
+        for (size_t i = 0; i < count; ++i)
+            target[offsets[(source[i].Key >> shift) & 0xff]++] = source[i];
+        std::swap(source, target);
+    }
+    if (source != m_Items.data())
+        m_Items.swap(m_Scratch);
+}
+
+RenderQueue::StateChanges RenderQueue::CountStateChanges() const
+{
+    StateChanges changes;
+    const DrawPacket *previous = nullptr;
+    for (const SortItem &item : m_Items)
+    {
+        const DrawPacket &packet = m_Packets[item.Index];
+        if (!previous || previous->Program != packet.Program)
+            changes.Shader++;
+        if (!previous || !SameMaterial(*previous, packet))
+            changes.Material++;
+        if (!previous || previous->Vertices != packet.Vertices || previous->Indices != packet.Indices)
+            changes.VertexArray++;
+        if (!previous || previous->Translucent != packet.Translucent)
+            changes.Blend++;
+        previous = &packet;
+    }
+    return changes;
+}
+
+void RenderQueue::Draw(const DrawPacket &packet, const DrawPacket *previous)
+{
+    GLStateCache &cache = GLStateCache::Get();
+    if (!previous || previous->Translucent != packet.Translucent)
+    {
+        if (packet.Translucent)
+        {
+            cache.Enable(GL_BLEND);
+            cache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        else
+            cache.Disable(GL_BLEND);
+        cache.DepthMask(!packet.Translucent);
+    }
+
+    for (uint slot = 0; slot < DrawPacket::MaxTextures; ++slot)
+        if (packet.Textures[slot])
+            packet.Textures[slot]->Bind(slot);
+    if (packet.Objects)
+        packet.Objects->BindRange(ObjectsBinding, packet.ObjectsOffset, packet.ObjectsSize);
+
+    /* Uniforms need the program bound, Renderer would bind it again (skipped by the cache) */
+    packet.Program->Bind();
+    if (packet.ModelUniform.IsValid())
+        packet.Program->SetUniformMat4f(packet.ModelUniform, packet.Model);
+    if (packet.ColorUniform.IsValid())
+    {
+        const glm::vec4 &color = packet.Color;
+        packet.Program->SetUniform4f(packet.ColorUniform, color.x, color.y, color.z, color.w);
+    }
+
+    Renderer renderer;
+    if (packet.InstanceCount > 1)
+        renderer.DrawInstanced(*packet.Vertices, *packet.Indices, *packet.Program, packet.InstanceCount);
+    else
+    {
+        uint indexCount = packet.IndexCount ? packet.IndexCount : packet.Indices->GetCount();
+        renderer.Draw(*packet.Vertices, *packet.Indices, *packet.Program, indexCount, packet.FirstIndex,
+                      packet.BaseVertex);
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "UniformBuffer.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+// Everything one draw needs. The pointers must stay alive until Execute().
+struct DrawPacket
+{
+    static constexpr uint MaxTextures = 4; // Bound to units 0 to 3
+
+    const VertexArray *Vertices = nullptr;
+    const IndexBuffer *Indices = nullptr;
+    Shader *Program = nullptr;
+    uint IndexCount = 0; // 0 draws the whole index buffer
+    uint FirstIndex = 0;
+    int BaseVertex = 0;
+    uint InstanceCount = 1; // More than 1 draws instanced (whole index buffer)
+
+    std::array<const Texture *, MaxTextures> Textures{}; // The material
+    UniformHandle ModelUniform; // Uniforms with an invalid handle are not set
+    glm::mat4 Model = glm::mat4(1.0f);
+    UniformHandle ColorUniform;
+    glm::vec4 Color = glm::vec4(1.0f);
+    const UniformBuffer *Objects = nullptr; // Instance data, bound to ObjectsBinding
+    uint ObjectsOffset = 0, ObjectsSize = 0;
+
+    uint Layer = 0;           // 0 to 15, higher layers draw later (e.g. UI)
+    bool Translucent = false; // Blended, no depth writes, drawn after the opaque pass
+    float Depth = 0.0f;       // 0 (near) to 1 (far)
+};
+
+/*
+ * Collects draws for a frame and executes them sorted by a 64 bit key:
+ *
+ *   63..60 layer | 59 translucent | 58..0 pass specific
+ *   opaque:      shader (12) | material (12) | depth (24), front to back
+ *   translucent: depth (24), back to front | shader (12) | material (12)
+ *
+ * so within a layer opaque draws come first, grouped by shader and then by
+ * textures, and translucent draws are blended in the right order. Shader and
+ * material IDs are small numbers handed out on first sight, collisions only
+ * cost sort quality. The sort is an LSD radix sort (stable, so equal keys
+ * keep their submission order) and the draws go through the GLStateCache.
+ */
+class RenderQueue
+{
+public:
+    struct StateChanges
+    {
+        uint Shader = 0;
+        uint Material = 0;
+        uint VertexArray = 0;
+        uint Blend = 0;
+
+        inline uint GetTotal() const { return Shader + Material + VertexArray + Blend; }
+    };
+    // Of the last Execute()
+    struct Stats
+    {
+        uint Packets = 0;
+        StateChanges Submitted; // In submission order, i.e. without the sort
+        StateChanges Executed;
+        double SortMs = 0.0;
+        double ExecuteMs = 0.0; // CPU time issuing the draws
+
+        // Negative when the sort added changes, e.g. translucent draws ordered by depth first
+        inline int GetRemoved() const { return (int)Submitted.GetTotal() - (int)Executed.GetTotal(); }
+    };
+
+private:
+    static constexpr uint IDBits = 12;
+    static constexpr uint DepthBits = 24;
+
+    struct SortItem
+    {
+        uint64_t Key;
+        uint Index; // Into m_Packets
+    };
+
+    std::vector<DrawPacket> m_Packets;
+    std::vector<SortItem> m_Items;
+    std::vector<SortItem> m_Scratch;
+    std::unordered_map<const Shader *, uint> m_ShaderIDs;
+    std::unordered_map<uint64_t, uint> m_MaterialIDs; // By hash of the texture IDs
+    bool m_Sorting = true;
+    Stats m_Stats;
+
+public:
+    RenderQueue() {}
+    ~RenderQueue() {}
+
+    void Submit(const DrawPacket &packet);
+    // Sorts (unless disabled), draws and empties the queue
+    void Execute();
+    void Clear();
+
+    // Off executes in submission order, to compare against
+    inline void SetSorting(bool enabled) { m_Sorting = enabled; }
+    inline bool IsSorting() const { return m_Sorting; }
+    inline uint GetPacketCount() const { return m_Packets.size(); }
+    inline const Stats &GetStats() const { return m_Stats; }
+
+private:
+    uint64_t CreateKey(const DrawPacket &packet);
+    uint GetShaderID(const Shader *shader);
+    uint GetMaterialID(const DrawPacket &packet);
+    void Sort();
+    StateChanges CountStateChanges() const; // Of m_Items in their current order
+    void Draw(const DrawPacket &packet, const DrawPacket *previous);
+};
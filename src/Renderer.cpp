@@ -0,0 +1,7 @@
+#include "Renderer.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+Renderer::Stats Renderer::s_Stats;
@@ -3,6 +3,7 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "Profiler.h"
 
 // ============================================================================
 // Class definition
@@ -11,15 +12,62 @@
 class Renderer
 {
 public:
+    struct Stats
+    {
+        uint DrawCalls = 0;
+    };
+
+private:
+    static Stats s_Stats; // Shared by all (stateless) Renderer instances
+
+public:
+    static const Stats &GetStats() { return s_Stats; }
+    static void ResetStats() { s_Stats = Stats(); }
+
     void Clear() const
     {
+        PROFILE_SCOPE("Renderer::Clear");
         GLCall(glClear(GL_COLOR_BUFFER_BIT)); // Clear before drawing
     }
     void Draw(const VertexArray &va, const IndexBuffer &ib, const Shader &shader) const
     {
+        PROFILE_SCOPE("Renderer::Draw");
         va.Bind();
         ib.Bind();
         shader.Bind();
         GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+        s_Stats.DrawCalls++;
+    }
+    // Draw only the first indexCount elements of ib (e.g. a partially filled batch)
+    void Draw(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, uint indexCount) const
+    {
+        PROFILE_SCOPE("Renderer::Draw");
+        va.Bind();
+        ib.Bind();
+        shader.Bind();
+        GLCall(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr));
+        s_Stats.DrawCalls++;
+    }
+    // Draw indexCount elements from firstIndex on, offset by baseVertex (e.g. streamed geometry)
+    void Draw(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, uint indexCount, uint firstIndex,
+              int baseVertex) const
+    {
+        PROFILE_SCOPE("Renderer::Draw");
+        va.Bind();
+        ib.Bind();
+        shader.Bind();
+        const void *offset = (const void *)(intptr_t)(firstIndex * sizeof(uint));
+        GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, offset, baseVertex));
+        s_Stats.DrawCalls++;
+    }
+    // Draw the same mesh instanceCount times, per instance data comes from divisor attributes
+    void DrawInstanced(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, uint instanceCount) const
+    {
+        PROFILE_SCOPE("Renderer::DrawInstanced");
+        va.Bind();
+        ib.Bind();
+        shader.Bind();
+        GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount));
+        s_Stats.DrawCalls++;
     }
 };
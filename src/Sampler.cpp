@@ -0,0 +1,47 @@
+#include "Sampler.h"
+
+#include <algorithm>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+Sampler::Sampler(uint minFilter, uint magFilter, float anisotropy, uint wrap) : m_RendererID(0), m_Anisotropy(1.0f)
+{
+    GLCall(glGenSamplers(1, &m_RendererID));
+    GLCall(glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_S, wrap));
+    GLCall(glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_T, wrap));
+    SetFilter(minFilter, magFilter);
+    SetAnisotropy(anisotropy);
+}
+
+void Sampler::SetFilter(uint minFilter, uint magFilter)
+{
+    GLCall(glSamplerParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, minFilter));
+    GLCall(glSamplerParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, magFilter));
+}
+
+void Sampler::SetAnisotropy(float anisotropy)
+{
+    float max = GetMaxAnisotropy();
+    m_Anisotropy = std::min(std::max(anisotropy, 1.0f), max);
+    if (max > 1.0f)
+    {
+        GLCall(glSamplerParameterf(m_RendererID, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_Anisotropy));
+    }
+}
+
+float Sampler::GetMaxAnisotropy()
+{
+    /* Core in 4.6, the EXT enums have the same values */
+    static float max = -1.0f;
+    if (max < 0.0f)
+    {
+        max = 1.0f;
+        if (GLEW_VERSION_4_6 || GLEW_ARB_texture_filter_anisotropic || GLEW_EXT_texture_filter_anisotropic)
+        {
+            GLCall(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max));
+        }
+    }
+    return max;
+}
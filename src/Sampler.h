@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Util.h"
+#include "GLStateCache.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * A GL sampler object. While bound to a unit it overrides the filtering and
+ * wrap parameters of whatever texture is bound there, so one sampler can be
+ * shared by many textures and switched without touching them.
+ */
+class Sampler
+{
+private:
+    uint m_RendererID;
+    float m_Anisotropy;
+
+public:
+    Sampler(uint minFilter = GL_LINEAR_MIPMAP_LINEAR, uint magFilter = GL_LINEAR, float anisotropy = 1.0f,
+            uint wrap = GL_CLAMP_TO_EDGE);
+    ~Sampler() { GLStateCache::Get().DeleteSampler(m_RendererID); }
+
+    void Bind(uint slot = 0) const { GLStateCache::Get().BindSampler(slot, m_RendererID); }
+    static void Unbind(uint slot = 0) { GLStateCache::Get().BindSampler(slot, 0); }
+
+    void SetFilter(uint minFilter, uint magFilter);
+    // Clamped to GetMaxAnisotropy(), 1 turns it off
+    void SetAnisotropy(float anisotropy);
+
+    inline uint GetRendererID() const { return m_RendererID; }
+    inline float GetAnisotropy() const { return m_Anisotropy; }
+    // 1 when anisotropic filtering is not supported
+    static float GetMaxAnisotropy();
+};
@@ -1,67 +1,246 @@
 #include "Shader.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include "ProgramCache.h"
+#include "ShaderLibrary.h"
+
 // ============================================================================
 // Implementation
 // ============================================================================
 
-Shader::Shader(const std::string &filepath) : m_Filepath(filepath), m_RendererID(0)
+namespace
 {
-    ShaderProgramSource source = ParseShader(filepath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    // Lets the driver compile on all of its threads, once per context
+    bool InitParallelCompile()
+    {
+        if (GLEW_KHR_parallel_shader_compile)
+        {
+            GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+            return true;
+        }
+        if (GLEW_ARB_parallel_shader_compile)
+        {
+            GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+            return true;
+        }
+        return false;
+    }
+
+    bool ParallelCompileSupported()
+    {
+        static bool supported = InitParallelCompile();
+        return supported;
+    }
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
 }
 
-ShaderProgramSource Shader::ParseShader(const std::string &filepath)
+Shader::Shader(const std::string &filepath, ShaderCompile mode) : Shader(filepath, {}, mode)
 {
-    std::ifstream stream(filepath);
+}
 
-    enum class ShaderType
-    {
-        NONE = -1,
-        VERTEX = 0,
-        FRAGMENT = 1
-    };
+Shader::Shader(const std::string &filepath, const std::vector<std::string> &defines, ShaderCompile mode)
+    : Shader(filepath, defines, mode, AssetPack::GetMounted())
+{
+}
+
+Shader::Shader(const AssetView &asset, const std::vector<std::string> &defines, ShaderCompile mode)
+    : Shader(std::string(asset.Path), defines, mode, asset.Pack)
+{
+}
 
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
-    while (getline(stream, line))
+Shader::Shader(const std::string &filepath, const std::vector<std::string> &defines, ShaderCompile mode,
+               const AssetPack *pack)
+    : m_Filepath(filepath), m_Defines(defines), m_RendererID(0), m_State(State::Ready), m_Stages{0, 0, 0, 0},
+      m_CacheKey(0), m_CompileMs(0.0), m_PlaceholderBound(false), m_ReloadRequested(false)
+{
+    auto start = std::chrono::steady_clock::now();
+    ShaderProgramSource sources;
+    bool parsed = ShaderPreprocessor(defines, pack).Process(filepath, sources);
+    m_Dependencies = sources.Dependencies;
+    if (!parsed)
+        return;
+
+    // A cached binary skips compiling and linking, the key covers every
+    // included file since it hashes the preprocessed stages
+    std::string expanded, defineKey;
+    for (const std::string &stage : sources.Sources)
+        expanded += stage + '\0';
+    for (const std::string &define : defines)
+        defineKey += define + '\n';
+    ProgramCache &cache = ProgramCache::Get();
+    m_CacheKey = cache.MakeKey(expanded, defineKey);
+    m_RendererID = cache.Load(m_CacheKey);
+    if (m_RendererID)
     {
-        if (line.find("shader") != std::string::npos)
+        cache.RecordLoad(MillisecondsSince(start));
+        OnProgramReady();
+        return;
+    }
+
+    SubmitShader(sources);
+    m_CompileMs += MillisecondsSince(start);
+    if (mode == ShaderCompile::Blocking)
+        WaitUntilReady();
+}
+
+Shader::~Shader()
+{
+    for (uint stage : m_Stages)
+        if (stage)
         {
-            if (line.find("vertex") != std::string::npos)
-                type = ShaderType::VERTEX;
-            else if (line.find("fragment") != std::string::npos)
-                type = ShaderType::FRAGMENT;
+            GLCall(glDeleteShader(stage));
         }
-        else
+    GLStateCache::Get().DeleteProgram(m_RendererID);
+}
+
+void Shader::Bind() const
+{
+    if (m_State == State::Ready)
+        GLStateCache::Get().UseProgram(m_RendererID);
+    else
+    {
+        // Upgraded to the real program in FinishProgram()
+        GLStateCache::Get().UseProgram(ShaderLibrary::Get().GetPlaceholderProgram());
+        m_PlaceholderBound = true;
+    }
+}
+
+void Shader::Link()
+{
+    if (m_State != State::Compiling)
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    // Think of this as compiling a C++ program
+    for (uint stage : m_Stages)
+        if (stage)
         {
-            ss[(int)type] << line << '\n';
+            GLCall(glAttachShader(m_RendererID, stage));
         }
+    ProgramCache::Get().PrepareProgram(m_RendererID);
+    GLCall(glLinkProgram(m_RendererID));
+    m_State = State::Linking;
+    m_CompileMs += MillisecondsSince(start);
+}
+
+bool Shader::IsReady()
+{
+    if (m_State == State::Ready)
+        return true;
+
+    Link();
+    if (ParallelCompileSupported())
+    {
+        int done = 0;
+        GLCall(glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &done));
+        if (!done)
+            return false;
     }
-    return {ss[0].str(), ss[1].str()};
+    FinishProgram();
+    return true;
+}
+
+void Shader::WaitUntilReady()
+{
+    if (m_State == State::Ready)
+        return;
+    Link();
+    FinishProgram();
+}
+
+namespace
+{
+    const uint s_StageTypes[4] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER, GL_COMPUTE_SHADER};
+    const char *s_StageNames[4] = {"vertex", "fragment", "geometry", "compute"};
 }
 
 /*
- * vertexShader and fragmentShader are strings
- * containing the shaders' source code 
+ * Submits every stage present in sources. Nothing here waits for the
+ * driver, errors are only queried in FinishProgram().
  */
-unsigned int Shader::CreateShader(const std::string &vertexShader, const std::string &fragmentShader)
+void Shader::SubmitShader(const ShaderProgramSource &sources)
 {
-    GLCall(unsigned int program = glCreateProgram());
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    GLCall(m_RendererID = glCreateProgram());
+    for (int stage = 0; stage < 4; ++stage)
+    {
+        if (sources.Sources[stage].empty())
+            continue;
+        if (stage == (int)ShaderStage::Compute && !(GLEW_VERSION_4_3 || GLEW_ARB_compute_shader))
+        {
+            std::cout << "Compute shaders need GL 4.3, skipping the stage in " << m_Filepath << std::endl;
+            continue;
+        }
+        m_Stages[stage] = CompileShader(s_StageTypes[stage], sources.Sources[stage]);
+    }
+    m_State = State::Compiling;
+}
 
-    // Think of this as compiling a C++ program
-    GLCall(glAttachShader(program, vs));
-    GLCall(glAttachShader(program, fs));
-    GLCall(glLinkProgram(program));
-    GLCall(glValidateProgram(program));
+// Blocks until the link is done (unless IsReady() saw it complete)
+void Shader::FinishProgram()
+{
+    auto start = std::chrono::steady_clock::now();
+    bool compiled = true;
+    for (int stage = 0; stage < 4; ++stage)
+        if (m_Stages[stage])
+            compiled = CheckShader(m_Stages[stage], s_StageTypes[stage]) && compiled;
 
     // Delete intermediate shaders (Already linked to program)
-    GLCall(glDeleteShader(vs));
-    GLCall(glDeleteShader(fs));
+    for (uint &stage : m_Stages)
+    {
+        if (!stage)
+            continue;
+        GLCall(glDetachShader(m_RendererID, stage));
+        GLCall(glDeleteShader(stage));
+        stage = 0;
+    }
 
-    return program;
+    int result;
+    GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &result));
+    if (!result)
+    {
+        if (compiled)
+        {
+            int length;
+            GLCall(glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length));
+            char *message = (char *)alloca(length * sizeof(char) + 1);
+            message[0] = '\0';
+            GLCall(glGetProgramInfoLog(m_RendererID, length, &length, message));
+            std::cout << "Failed to link " << m_Filepath << std::endl;
+            std::cout << message << std::endl;
+        }
+        GLStateCache::Get().DeleteProgram(m_RendererID);
+        m_RendererID = 0;
+    }
+    else
+    {
+        GLCall(glValidateProgram(m_RendererID));
+        ProgramCache::Get().Save(m_CacheKey, m_RendererID);
+    }
+    m_State = State::Ready;
+    m_CompileMs += MillisecondsSince(start);
+    ProgramCache::Get().RecordCompile(m_CompileMs);
+
+    if (m_PlaceholderBound && GLStateCache::Get().GetProgram() == ShaderLibrary::Get().GetPlaceholderProgram())
+        GLStateCache::Get().UseProgram(m_RendererID);
+    m_PlaceholderBound = false;
+    if (m_RendererID)
+        OnProgramReady();
+}
+
+void Shader::OnProgramReady()
+{
+    IntrospectUniforms();
+
+    // Shared blocks always live at the same binding point, so a UBO bound
+    // once per frame serves every shader that declares the block
+    SetUniformBlockBinding("Camera", CameraBinding);
+    SetUniformBlockBinding("Objects", ObjectsBinding);
 }
 
 unsigned int Shader::CompileShader(unsigned int type, const std::string &source)
@@ -72,7 +251,11 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string &source)
     GLCall(glShaderSource(id, 1, &src, nullptr)); // 1 source code, pointer to pointer
     // nullptr can be used if the string is null terminated.
     GLCall(glCompileShader(id));
+    return id;
+}
 
+bool Shader::CheckShader(uint id, uint type)
+{
     // Error handling
     int result;
     GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result)); // iv = integer 'vector' i.e. array pointer
@@ -86,43 +269,242 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string &source)
         GLCall(glGetShaderInfoLog(id, length, &length, message));
 
         // Print error message to console
-        std::string shaderType = (type == GL_VERTEX_SHADER ? "vertex" : "fragment");
-        std::cout << "Failed to compile " << shaderType << " shader." << std::endl;
+        std::string shaderType = s_StageNames[std::find(s_StageTypes, s_StageTypes + 4, type) - s_StageTypes];
+        std::cout << "Failed to compile " << shaderType << " shader in " << m_Filepath << "." << std::endl;
         std::cout << message << std::endl;
-        GLCall(glDeleteShader(id));
-        return 0;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Reads every active uniform after linking. Block members have no location
+ * and are skipped, arrays are stored under their base name. Names already in
+ * the table keep their index so UniformHandles survive a reload; uniforms
+ * that disappeared get location -1.
+ */
+void Shader::IntrospectUniforms()
+{
+    for (UniformInfo &info : m_Uniforms)
+        info.Location = -1;
+    m_MissingUniforms.clear();
+
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    std::vector<char> buffer(maxLength + 1);
+    for (int i = 0; i < count; ++i)
+    {
+        int length = 0, size = 0;
+        GLenum type = 0;
+        GLCall(glGetActiveUniform(m_RendererID, i, buffer.size(), &length, &size, &type, buffer.data()));
+        std::string name(buffer.data(), length);
+        GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
+        if (location == -1)
+            continue;
+
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+        auto it = std::find_if(m_Uniforms.begin(), m_Uniforms.end(),
+                               [&](const UniformInfo &info) { return info.Name == name; });
+        if (it != m_Uniforms.end())
+            *it = {std::move(name), it->Hash, location, type, size};
+        else
+        {
+            uint32_t hash = HashUniformName(name);
+            m_Uniforms.push_back({std::move(name), hash, location, type, size});
+        }
+    }
+
+    m_UniformOrder.resize(m_Uniforms.size());
+    for (size_t i = 0; i < m_Uniforms.size(); ++i)
+        m_UniformOrder[i] = i;
+    std::sort(m_UniformOrder.begin(), m_UniformOrder.end(),
+              [&](int a, int b) { return m_Uniforms[a].Hash < m_Uniforms[b].Hash; });
+}
+
+UniformHandle Shader::GetUniformHandle(UniformName name)
+{
+    WaitUntilReady();
+    auto it = std::lower_bound(m_UniformOrder.begin(), m_UniformOrder.end(), name.Hash,
+                               [&](int index, uint32_t hash) { return m_Uniforms[index].Hash < hash; });
+    for (; it != m_UniformOrder.end() && m_Uniforms[*it].Hash == name.Hash; ++it)
+        if (m_Uniforms[*it].Name == name.Name && m_Uniforms[*it].Location != -1)
+            return {*it};
+
+    if (std::find(m_MissingUniforms.begin(), m_MissingUniforms.end(), name.Hash) == m_MissingUniforms.end())
+    {
+        m_MissingUniforms.push_back(name.Hash);
+        std::cout << "Warning: uniform '" << name.Name << "' doesn't exist in " << m_Filepath << "!" << std::endl;
+    }
+    return {};
+}
+
+void Shader::Reload()
+{
+    if (IsPending())
+    {
+        /* Still compiling the first version, which may predate the edit: reload once it is done */
+        m_ReloadRequested = true;
+        return;
+    }
+    m_ReloadRequested = false;
+    m_Reload.reset(new Shader(m_Filepath, m_Defines, ShaderCompile::Async, nullptr));
+    m_Reload->Link();
+}
+
+Shader::ReloadStatus Shader::PollReload()
+{
+    if (m_ReloadRequested)
+    {
+        if (!IsReady())
+            return ReloadStatus::Pending;
+        Reload();
+    }
+    if (!m_Reload)
+        return ReloadStatus::Idle;
+    if (!m_Reload->IsReady())
+        return ReloadStatus::Pending;
+
+    std::unique_ptr<Shader> reload = std::move(m_Reload);
+    if (!reload->m_RendererID)
+        return ReloadStatus::Failed;
+
+    // Program IDs are swapped, so the old program dies with reload
+    CopyUniformValues(reload->m_RendererID, reload->m_Uniforms);
+    std::swap(m_RendererID, reload->m_RendererID);
+    m_Dependencies = reload->m_Dependencies;
+    OnProgramReady();
+    return ReloadStatus::Swapped;
+}
+
+namespace
+{
+    // Copies one uniform (or array element) between programs, target must be in use
+    void CopyUniform(uint source, int sourceLocation, int targetLocation, GLenum type)
+    {
+        float f[16];
+        int i[4];
+        switch (type)
+        {
+        case GL_FLOAT:
+        case GL_FLOAT_VEC2:
+        case GL_FLOAT_VEC3:
+        case GL_FLOAT_VEC4:
+        case GL_FLOAT_MAT3:
+        case GL_FLOAT_MAT4:
+            GLCall(glGetUniformfv(source, sourceLocation, f));
+            break;
+        case GL_INT:
+        case GL_INT_VEC2:
+        case GL_INT_VEC3:
+        case GL_INT_VEC4:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_CUBE:
+            GLCall(glGetUniformiv(source, sourceLocation, i));
+            break;
+        default:
+            return;
+        }
+
+        switch (type)
+        {
+        case GL_FLOAT:
+            GLCall(glUniform1fv(targetLocation, 1, f));
+            break;
+        case GL_FLOAT_VEC2:
+            GLCall(glUniform2fv(targetLocation, 1, f));
+            break;
+        case GL_FLOAT_VEC3:
+            GLCall(glUniform3fv(targetLocation, 1, f));
+            break;
+        case GL_FLOAT_VEC4:
+            GLCall(glUniform4fv(targetLocation, 1, f));
+            break;
+        case GL_FLOAT_MAT3:
+            GLCall(glUniformMatrix3fv(targetLocation, 1, GL_FALSE, f));
+            break;
+        case GL_FLOAT_MAT4:
+            GLCall(glUniformMatrix4fv(targetLocation, 1, GL_FALSE, f));
+            break;
+        case GL_INT_VEC2:
+            GLCall(glUniform2iv(targetLocation, 1, i));
+            break;
+        case GL_INT_VEC3:
+            GLCall(glUniform3iv(targetLocation, 1, i));
+            break;
+        case GL_INT_VEC4:
+            GLCall(glUniform4iv(targetLocation, 1, i));
+            break;
+        default: // Scalars, bools and samplers
+            GLCall(glUniform1iv(targetLocation, 1, i));
+            break;
+        }
+    }
+}
+
+// Carries values set once (sampler units etc.) over to a reloaded program
+void Shader::CopyUniformValues(uint target, const std::vector<UniformInfo> &targetUniforms) const
+{
+    GLStateCache::Get().UseProgram(target);
+    for (const UniformInfo &info : targetUniforms)
+    {
+        auto it = std::find_if(m_Uniforms.begin(), m_Uniforms.end(),
+                               [&](const UniformInfo &old) { return old.Name == info.Name; });
+        if (it == m_Uniforms.end() || it->Location == -1 || it->Type != info.Type)
+            continue;
+
+        int count = std::min(info.Count, it->Count);
+        for (int element = 0; element < count; ++element)
+        {
+            if (element == 0)
+            {
+                CopyUniform(m_RendererID, it->Location, info.Location, info.Type);
+                continue;
+            }
+            std::string name = info.Name + '[' + std::to_string(element) + ']';
+            GLCall(int sourceLocation = glGetUniformLocation(m_RendererID, name.c_str()));
+            GLCall(int targetLocation = glGetUniformLocation(target, name.c_str()));
+            if (sourceLocation != -1 && targetLocation != -1)
+                CopyUniform(m_RendererID, sourceLocation, targetLocation, info.Type);
+        }
     }
-    return id;
 }
 
-void Shader::SetUniform1i(const std::string &name, int v0)
+void Shader::SetUniform1i(UniformHandle handle, int v0)
 {
-    GLCall(glUniform1i(GetUniformLocation(name), v0));
+    GLCall(glUniform1i(GetUniformLocation(handle), v0));
 }
 
-void Shader::SetUniform1f(const std::string &name, float v0)
+void Shader::SetUniform1iv(UniformHandle handle, int count, const int *values)
 {
-    GLCall(glUniform1f(GetUniformLocation(name), v0));
+    GLCall(glUniform1iv(GetUniformLocation(handle), count, values));
 }
 
-void Shader::SetUniform4f(const std::string &name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform1f(UniformHandle handle, float v0)
 {
-    GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+    GLCall(glUniform1f(GetUniformLocation(handle), v0));
 }
 
-void Shader::SetUniformMat4f(const std::string &name, const glm::mat4 &matrix)
+void Shader::SetUniform4f(UniformHandle handle, float v0, float v1, float v2, float v3)
+{
+    GLCall(glUniform4f(GetUniformLocation(handle), v0, v1, v2, v3));
+}
+
+void Shader::SetUniformMat4f(UniformHandle handle, const glm::mat4 &matrix)
 {
     // 1 is the no. of matrices and GL_FALSE is used when using GLM matrices
-    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    GLCall(glUniformMatrix4fv(GetUniformLocation(handle), 1, GL_FALSE, &matrix[0][0]));
 }
 
-int Shader::GetUniformLocation(const std::string &name)
+bool Shader::SetUniformBlockBinding(const std::string &blockName, uint binding)
 {
-    if (m_UniformLocationCache.count(name))
-        return m_UniformLocationCache.at(name);
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
-        std::cout << "Warning: uniform'" << name << " doesn't exist!" << std::endl;
-    m_UniformLocationCache[name] = location;
-    return location;
-}
\ No newline at end of file
+    GLCall(uint index = glGetUniformBlockIndex(m_RendererID, blockName.c_str()));
+    if (index == GL_INVALID_INDEX)
+        return false;
+    GLCall(glUniformBlockBinding(m_RendererID, index, binding));
+    return true;
+}
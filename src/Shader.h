@@ -1,46 +1,182 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <memory>
 #include <glm/glm.hpp>
 #include <string>
-#include <sstream> // string stream
-#include <fstream> // file reader
+#include <string_view>
+#include <vector>
 
 #include "Util.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
+#include "ShaderPreprocessor.h"
+#include "AssetPack.h"
 
 // ============================================================================
 // Class definition
 // ============================================================================
 
-struct ShaderProgramSource
+// FNV-1a, constexpr so names known at compile time are hashed at compile time
+constexpr uint32_t HashUniformName(std::string_view name)
 {
-    std::string VertexSource;
-    std::string FragmentSource;
+    uint32_t hash = 2166136261u;
+    for (char c : name)
+        hash = (hash ^ (unsigned char)c) * 16777619u;
+    return hash;
+}
+
+/*
+ * A uniform name with its hash. Converts implicitly from string literals and
+ * strings so the name-based setters never build a temporary std::string.
+ */
+struct UniformName
+{
+    std::string_view Name;
+    uint32_t Hash;
+
+    constexpr UniformName(const char *name) : Name(name), Hash(HashUniformName(Name)) {}
+    constexpr UniformName(std::string_view name) : Name(name), Hash(HashUniformName(name)) {}
+    UniformName(const std::string &name) : Name(name), Hash(HashUniformName(Name)) {}
+};
+
+// Index into the uniform table of one Shader, resolve once and keep it
+struct UniformHandle
+{
+    int Index = -1;
+
+    inline bool IsValid() const { return Index >= 0; }
+};
+
+enum class ShaderCompile
+{
+    Blocking, // Compile and link in the constructor
+    Async     // Only submit the compile, see Shader::IsReady()
 };
 
+/*
+ * An Async shader submits its stages to the driver and returns. With
+ * KHR_parallel_shader_compile the driver compiles and links on its own
+ * threads and IsReady() polls GL_COMPLETION_STATUS_KHR; without it IsReady()
+ * simply finishes the work. Until then Bind() uses a placeholder program,
+ * and anything touching uniforms waits for the real one.
+ */
 class Shader
 {
 private:
+    enum class State
+    {
+        Compiling, // Stages submitted, not linked yet
+        Linking,   // Link submitted, status not checked yet
+        Ready
+    };
+
     std::string m_Filepath;
+    std::vector<std::string> m_Defines;
+    std::vector<std::string> m_Dependencies; // The file and everything it includes
     uint m_RendererID;
-    std::unordered_map<std::string, int> m_UniformLocationCache;
+    State m_State;
+    uint m_Stages[4];    // Indexed by ShaderStage, until checked
+    uint64_t m_CacheKey; // ProgramCache entry to save once linked
+    double m_CompileMs;  // Main thread time spent compiling this program
+    mutable bool m_PlaceholderBound;
+
+    struct UniformInfo
+    {
+        std::string Name; // Arrays without the trailing "[0]"
+        uint32_t Hash;
+        int Location;
+        uint Type; // GL_FLOAT_MAT4 etc.
+        int Count; // Array size, 1 otherwise
+    };
+    std::vector<UniformInfo> m_Uniforms;    // Indexed by UniformHandle, never reordered
+    std::vector<int> m_UniformOrder;        // Indices into m_Uniforms sorted by hash
+    std::vector<uint32_t> m_MissingUniforms; // Names already warned about
+    std::unique_ptr<Shader> m_Reload;       // Replacement program being compiled
+    bool m_ReloadRequested;                 // Edited while the first program was still compiling
 
 public:
-    Shader(const std::string &filepath);
-    ~Shader() { GLCall(glDeleteProgram(m_RendererID)); }
+    // Reads through the mounted AssetPack when it has the file
+    Shader(const std::string &filepath, ShaderCompile mode = ShaderCompile::Blocking);
+    // defines ("NAME" or "NAME=VALUE") select a permutation, see ShaderPreprocessor
+    Shader(const std::string &filepath, const std::vector<std::string> &defines,
+           ShaderCompile mode = ShaderCompile::Blocking);
+    // Includes resolve inside the asset's pack
+    Shader(const AssetView &asset, const std::vector<std::string> &defines = {},
+           ShaderCompile mode = ShaderCompile::Blocking);
+    ~Shader();
+
+    void Bind() const;
+    void Unbind() const { GLStateCache::Get().UseProgram(0); }
+    inline uint GetRendererID() const { return m_RendererID; }
+    inline const std::string &GetFilepath() const { return m_Filepath; }
+    inline const std::vector<std::string> &GetDefines() const { return m_Defines; }
+    inline const std::vector<std::string> &GetDependencies() const { return m_Dependencies; }
+
+    // Submits the link of an Async shader, so a batch can compile everything first
+    void Link();
+    // Never blocks when the driver compiles in parallel
+    bool IsReady();
+    inline bool IsPending() const { return m_State != State::Ready; }
+    void WaitUntilReady();
 
-    void Bind() const { GLCall(glUseProgram(m_RendererID)); }
-    void Unbind() const { GLCall(glUseProgram(0)); }
+    /*
+     * Hot reload: Reload() compiles the file again next to the live program,
+     * PollReload() swaps the program in once it linked. Uniform values carry
+     * over and existing UniformHandles stay valid. Reloads always read the
+     * loose files, so edits show up even when the shader came from a pack.
+     */
+    enum class ReloadStatus
+    {
+        Idle,
+        Pending,
+        Swapped,
+        Failed // The previous program is kept
+    };
+    void Reload();
+    ReloadStatus PollReload();
 
-    // Set uniforms
-    void SetUniform1i(const std::string &name, int v0);
-    void SetUniform1f(const std::string &name, float v0);
-    void SetUniform4f(const std::string &name, float v0, float v1, float v2, float v3);
-    void SetUniformMat4f(const std::string &name, const glm::mat4 &matrix);
+    // Returns an invalid handle (and warns once) if the uniform is not active
+    UniformHandle GetUniformHandle(UniformName name);
+
+    // Set uniforms by handle (no lookup at all) or by name (binary search)
+    void SetUniform1i(UniformHandle handle, int v0);
+    void SetUniform1iv(UniformHandle handle, int count, const int *values);
+    void SetUniform1f(UniformHandle handle, float v0);
+    void SetUniform4f(UniformHandle handle, float v0, float v1, float v2, float v3);
+    void SetUniformMat4f(UniformHandle handle, const glm::mat4 &matrix);
+
+    void SetUniform1i(UniformName name, int v0) { SetUniform1i(GetUniformHandle(name), v0); }
+    void SetUniform1iv(UniformName name, int count, const int *values)
+    {
+        SetUniform1iv(GetUniformHandle(name), count, values);
+    }
+    void SetUniform1f(UniformName name, float v0) { SetUniform1f(GetUniformHandle(name), v0); }
+    void SetUniform4f(UniformName name, float v0, float v1, float v2, float v3)
+    {
+        SetUniform4f(GetUniformHandle(name), v0, v1, v2, v3);
+    }
+    void SetUniformMat4f(UniformName name, const glm::mat4 &matrix)
+    {
+        SetUniformMat4f(GetUniformHandle(name), matrix);
+    }
+
+    // Returns false if the program has no uniform block with that name
+    bool SetUniformBlockBinding(const std::string &blockName, uint binding);
 
 private:
-    ShaderProgramSource ParseShader(const std::string &filepath);
+    Shader(const std::string &filepath, const std::vector<std::string> &defines, ShaderCompile mode,
+           const AssetPack *pack);
+
     uint CompileShader(uint type, const std::string &source);
-    uint CreateShader(const std::string &vertexShader, const std::string &fragmentShader);
-    int GetUniformLocation(const std::string &name);
+    bool CheckShader(uint id, uint type);
+    void SubmitShader(const ShaderProgramSource &sources);
+    void FinishProgram();
+    void OnProgramReady();
+    void IntrospectUniforms();
+    void CopyUniformValues(uint target, const std::vector<UniformInfo> &targetUniforms) const;
+    inline int GetUniformLocation(UniformHandle handle) const
+    {
+        return handle.IsValid() ? m_Uniforms[handle.Index].Location : -1;
+    }
 };
\ No newline at end of file
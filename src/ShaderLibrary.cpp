@@ -0,0 +1,170 @@
+#include "ShaderLibrary.h"
+
+#include <algorithm>
+#include <dirent.h>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+ShaderLibrary &ShaderLibrary::Get()
+{
+    static ShaderLibrary library;
+    return library;
+}
+
+std::string ShaderLibrary::GetVariantKey(const std::string &filepath, std::vector<std::string> defines)
+{
+    std::sort(defines.begin(), defines.end());
+    std::string key = filepath;
+    for (const std::string &define : defines)
+        key += '|' + define;
+    return key;
+}
+
+void ShaderLibrary::WatchDependencies(const Shader &shader)
+{
+    if (m_Watcher)
+        for (const std::string &filepath : shader.GetDependencies())
+            m_Watcher->Watch(filepath);
+}
+
+std::shared_ptr<Shader> ShaderLibrary::Load(const std::string &filepath, const std::vector<std::string> &defines)
+{
+    std::string key = GetVariantKey(filepath, defines);
+    auto it = m_Shaders.find(key);
+    if (it != m_Shaders.end())
+    {
+        m_Stats.Hits++;
+        return it->second;
+    }
+    m_Stats.Misses++;
+    std::shared_ptr<Shader> shader = std::make_shared<Shader>(filepath, defines);
+    m_Shaders.emplace(key, shader);
+    WatchDependencies(*shader);
+    return shader;
+}
+
+void ShaderLibrary::Preload(const std::vector<ShaderVariant> &variants)
+{
+    size_t first = m_Pending.size();
+    for (const ShaderVariant &variant : variants)
+    {
+        std::string key = GetVariantKey(variant.Filepath, variant.Defines);
+        if (m_Shaders.count(key))
+            continue;
+        std::shared_ptr<Shader> shader =
+            std::make_shared<Shader>(variant.Filepath, variant.Defines, ShaderCompile::Async);
+        m_Shaders.emplace(key, shader);
+        WatchDependencies(*shader);
+        if (shader->IsPending()) // Cache hits are ready right away
+            m_Pending.push_back(shader);
+    }
+    /* Link only once every compile is queued, so the driver sees them all */
+    for (size_t i = first; i < m_Pending.size(); ++i)
+        m_Pending[i]->Link();
+    m_Stats.Pending = m_Pending.size();
+}
+
+void ShaderLibrary::PreloadDirectory(const std::string &directory)
+{
+    auto isShader = [](const std::string &name) {
+        return name.size() > 7 && name.compare(name.size() - 7, 7, ".shader") == 0;
+    };
+    std::vector<ShaderVariant> variants;
+    if (const AssetPack *pack = AssetPack::GetMounted())
+    {
+        /* Packed shaders directly in the directory, not in subdirectories */
+        for (uint i = 0; i < pack->GetAssetCount(); ++i)
+        {
+            std::string path(pack->GetAsset(i).Path);
+            if (path.size() > directory.size() + 1 && path.compare(0, directory.size(), directory) == 0 &&
+                path[directory.size()] == '/' && path.find('/', directory.size() + 1) == std::string::npos &&
+                isShader(path))
+                variants.push_back({path, {}});
+        }
+    }
+    else if (DIR *dir = opendir(directory.c_str()))
+    {
+        while (dirent *entry = readdir(dir))
+            if (isShader(entry->d_name))
+                variants.push_back({directory + '/' + entry->d_name, {}});
+        closedir(dir);
+    }
+    std::sort(variants.begin(), variants.end(),
+              [](const ShaderVariant &a, const ShaderVariant &b) { return a.Filepath < b.Filepath; });
+    Preload(variants);
+}
+
+void ShaderLibrary::SetHotReload(bool enabled)
+{
+    if (!enabled)
+    {
+        m_Watcher.reset();
+        return;
+    }
+    if (m_Watcher)
+        return;
+    m_Watcher = std::make_unique<FileWatcher>();
+    for (auto &entry : m_Shaders)
+        WatchDependencies(*entry.second);
+}
+
+void ShaderLibrary::Update()
+{
+    m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(),
+                                   [](const std::shared_ptr<Shader> &shader) { return shader->IsReady(); }),
+                    m_Pending.end());
+    m_Stats.Pending = m_Pending.size();
+
+    if (m_Watcher)
+    {
+        /* An edited include reloads every variant of every file using it */
+        for (const std::string &filepath : m_Watcher->Poll())
+            for (auto &entry : m_Shaders)
+            {
+                const std::vector<std::string> &dependencies = entry.second->GetDependencies();
+                if (std::find(dependencies.begin(), dependencies.end(), filepath) == dependencies.end())
+                    continue;
+                entry.second->Reload(); // A newer edit replaces a reload still in flight
+                if (std::find(m_Reloading.begin(), m_Reloading.end(), entry.second) == m_Reloading.end())
+                    m_Reloading.push_back(entry.second);
+            }
+    }
+
+    for (auto it = m_Reloading.begin(); it != m_Reloading.end();)
+    {
+        Shader::ReloadStatus status = (*it)->PollReload();
+        if (status == Shader::ReloadStatus::Swapped)
+        {
+            m_Stats.Reloads++;
+            std::cout << "Reloaded " << (*it)->GetFilepath() << std::endl;
+            WatchDependencies(**it); // It may include new files now
+        }
+        else if (status == Shader::ReloadStatus::Failed)
+        {
+            m_Stats.ReloadFailures++;
+            std::cout << "Reloading " << (*it)->GetFilepath() << " failed, keeping the previous program" << std::endl;
+        }
+        it = status == Shader::ReloadStatus::Pending ? it + 1 : m_Reloading.erase(it);
+    }
+}
+
+void ShaderLibrary::Clear()
+{
+    m_Pending.clear();
+    m_Reloading.clear();
+    m_Shaders.clear();
+    m_Placeholder.reset();
+    m_Stats.Pending = 0;
+}
+
+uint ShaderLibrary::GetPlaceholderProgram()
+{
+    if (!m_Placeholder)
+    {
+        m_Placeholder = Load("res/shaders/Placeholder.shader");
+        m_Placeholder->WaitUntilReady(); // It may have been preloaded
+    }
+    return m_Placeholder->GetRendererID();
+}
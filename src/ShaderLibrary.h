@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+#include "FileWatcher.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+struct ShaderVariant
+{
+    std::string Filepath;
+    std::vector<std::string> Defines;
+};
+
+/*
+ * Owns one Shader per file and set of defines (a variant) for the lifetime
+ * of the GL context, so opening a test twice (or two tests using the same
+ * file) compiles the file once, and only variants someone asked for exist.
+ * Preload() starts compiling files in the background before anything asks
+ * for them. Clear() must run before the context is destroyed.
+ */
+class ShaderLibrary
+{
+public:
+    struct Stats
+    {
+        uint Hits = 0;    // Load() calls served from memory
+        uint Misses = 0;  // Load() calls that created a Shader
+        uint Pending = 0; // Preloaded shaders still compiling
+        uint Reloads = 0; // Hot reloads swapped in
+        uint ReloadFailures = 0;
+    };
+
+private:
+    std::unordered_map<std::string, std::shared_ptr<Shader>> m_Shaders; // By GetVariantKey()
+    std::vector<std::shared_ptr<Shader>> m_Pending;
+    std::vector<std::shared_ptr<Shader>> m_Reloading;
+    std::shared_ptr<Shader> m_Placeholder;
+    std::unique_ptr<FileWatcher> m_Watcher; // Only while hot reload is on
+    Stats m_Stats;
+
+    ShaderLibrary() {}
+
+public:
+    static ShaderLibrary &Get();
+
+    // The returned shader may still be compiling if it was preloaded
+    std::shared_ptr<Shader> Load(const std::string &filepath, const std::vector<std::string> &defines = {});
+    // Submits every compile first and every link second, then returns
+    void Preload(const std::vector<ShaderVariant> &variants);
+    // Every .shader file in directory (of the mounted pack, if any), without defines
+    void PreloadDirectory(const std::string &directory);
+    // Recompiles shaders whose file changed, swapping them in once linked
+    void SetHotReload(bool enabled);
+    inline bool IsHotReloadEnabled() const { return m_Watcher != nullptr; }
+    // Finishes preloaded shaders and reloads whose compile is done, call once a frame
+    void Update();
+    void Clear();
+
+    // Drawn with while a shader is compiling
+    uint GetPlaceholderProgram();
+    inline const Stats &GetStats() const { return m_Stats; }
+    inline uint GetVariantCount() const { return m_Shaders.size(); }
+
+private:
+    // The defines are sorted, so their order does not create new variants
+    static std::string GetVariantKey(const std::string &filepath, std::vector<std::string> defines);
+    void WatchDependencies(const Shader &shader);
+};
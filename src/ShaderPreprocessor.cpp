@@ -0,0 +1,170 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    // Returns the directive's argument if line starts with it (after whitespace)
+    bool MatchDirective(const std::string &line, const char *directive, std::string &argument)
+    {
+        size_t start = line.find_first_not_of(" \t");
+        size_t length = strlen(directive);
+        if (start == std::string::npos || line.compare(start, length, directive) != 0)
+            return false;
+        size_t end = start + length;
+        if (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r')
+            return false; // e.g. #shaderfoo
+        size_t first = line.find_first_not_of(" \t", end);
+        size_t last = line.find_last_not_of(" \t\r");
+        argument = first == std::string::npos || first > last ? "" : line.substr(first, last - first + 1);
+        return true;
+    }
+
+    std::string GetDirectory(const std::string &filepath)
+    {
+        size_t slash = filepath.find_last_of('/');
+        return slash == std::string::npos ? "" : filepath.substr(0, slash + 1);
+    }
+}
+
+ShaderPreprocessor::ShaderPreprocessor(const std::vector<std::string> &defines, const AssetPack *pack)
+    : m_Defines(defines), m_Pack(pack), m_VersionSeen{false, false, false, false}, m_Stage(-1), m_Failed(false)
+{
+}
+
+bool ShaderPreprocessor::ReadFile(const std::string &filepath, std::string &contents)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream)
+        return false;
+    contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool ShaderPreprocessor::Read(const std::string &filepath, std::string &contents) const
+{
+    AssetView asset = m_Pack ? m_Pack->Find(filepath) : AssetView();
+    if (!asset.IsValid())
+        return ReadFile(filepath, contents);
+    contents.assign(asset.GetText()); // Lines get rewritten anyway
+    return true;
+}
+
+bool ShaderPreprocessor::Process(const std::string &filepath, ShaderProgramSource &result)
+{
+    GetFileIndex(filepath); // Watched for hot reload even if missing
+    std::string source;
+    if (!Read(filepath, source))
+    {
+        std::cout << "Failed to open " << filepath << std::endl;
+        return false;
+    }
+    ProcessFile(filepath, source, 0);
+
+    /* Stages without #version still get their defines, at the very top */
+    for (int stage = 0; stage < 4; ++stage)
+        if (!m_VersionSeen[stage] && !m_Result.Sources[stage].empty())
+            m_Result.Sources[stage] = GetDefineLines() + m_Result.Sources[stage];
+
+    result = std::move(m_Result);
+    return !m_Failed;
+}
+
+void ShaderPreprocessor::ProcessFile(const std::string &filepath, const std::string &source, int depth)
+{
+    int fileIndex = GetFileIndex(filepath);
+    std::istringstream stream(source);
+    std::string line, argument;
+    for (int lineNumber = 1; getline(stream, line); ++lineNumber)
+    {
+        if (MatchDirective(line, "#shader", argument))
+        {
+            static const char *names[] = {"vertex", "fragment", "geometry", "compute"};
+            auto it = std::find(std::begin(names), std::end(names), argument);
+            if (depth > 0 || it == std::end(names))
+            {
+                std::cout << filepath << ":" << lineNumber << ": invalid '" << line << "'" << std::endl;
+                m_Failed = true;
+                return;
+            }
+            m_Stage = it - std::begin(names);
+            continue;
+        }
+        if (m_Stage < 0)
+        {
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+                std::cout << filepath << ":" << lineNumber << ": ignored, no #shader stage yet" << std::endl;
+            continue;
+        }
+
+        std::string &out = m_Result.Sources[m_Stage];
+        if (MatchDirective(line, "#include", argument))
+        {
+            if (argument.size() < 2 || argument.front() != '"' || argument.back() != '"')
+            {
+                std::cout << filepath << ":" << lineNumber << ": expected #include \"file\"" << std::endl;
+                m_Failed = true;
+                return;
+            }
+            std::string included = GetDirectory(filepath) + argument.substr(1, argument.size() - 2);
+            std::vector<std::string> &guard = m_Included[m_Stage];
+            if (std::find(guard.begin(), guard.end(), included) != guard.end())
+                continue;
+            guard.push_back(included);
+
+            std::string contents;
+            if (depth + 1 >= MaxIncludeDepth || !Read(included, contents))
+            {
+                std::cout << filepath << ":" << lineNumber << ": cannot include " << included << std::endl;
+                m_Failed = true;
+                return;
+            }
+            out += "#line 1 " + std::to_string(GetFileIndex(included)) + '\n';
+            ProcessFile(included, contents, depth + 1);
+            if (m_Failed)
+                return;
+            out += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(fileIndex) + '\n';
+            continue;
+        }
+
+        out += line;
+        out += '\n';
+        if (MatchDirective(line, "#version", argument) && !m_VersionSeen[m_Stage])
+        {
+            m_VersionSeen[m_Stage] = true;
+            out += GetDefineLines();
+            out += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(fileIndex) + '\n';
+        }
+    }
+}
+
+int ShaderPreprocessor::GetFileIndex(const std::string &filepath)
+{
+    std::vector<std::string> &files = m_Result.Dependencies;
+    auto it = std::find(files.begin(), files.end(), filepath);
+    if (it != files.end())
+        return it - files.begin();
+    files.push_back(filepath);
+    return files.size() - 1;
+}
+
+std::string ShaderPreprocessor::GetDefineLines() const
+{
+    std::string lines;
+    for (const std::string &define : m_Defines)
+    {
+        size_t equals = define.find('=');
+        if (equals == std::string::npos)
+            lines += "#define " + define + '\n';
+        else
+            lines += "#define " + define.substr(0, equals) + ' ' + define.substr(equals + 1) + '\n';
+    }
+    return lines;
+}
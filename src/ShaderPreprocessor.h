@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Util.h"
+#include "AssetPack.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+enum class ShaderStage
+{
+    Vertex = 0,
+    Fragment = 1,
+    Geometry = 2,
+    Compute = 3
+};
+
+struct ShaderProgramSource
+{
+    std::string Sources[4];                // Indexed by ShaderStage, empty if absent
+    std::vector<std::string> Dependencies; // Every file read, the .shader file first
+
+    inline const std::string &Get(ShaderStage stage) const { return Sources[(int)stage]; }
+};
+
+/*
+ * Splits a .shader file into stages and expands it:
+ *   #shader vertex|fragment|geometry|compute   (only at the start of a line)
+ *   #include "file"   relative to the including file, each file at most
+ *                     once per stage, as if it had #pragma once
+ * The defines ("NAME" or "NAME=VALUE") are injected right after #version.
+ * #line directives keep compiler messages pointing at the right file, the
+ * source string number being the index into Dependencies. With a pack,
+ * files are read from it first and from disk if it lacks them.
+ */
+class ShaderPreprocessor
+{
+private:
+    static constexpr int MaxIncludeDepth = 16;
+
+    std::vector<std::string> m_Defines;
+    const AssetPack *m_Pack;
+    ShaderProgramSource m_Result;
+    std::vector<std::string> m_Included[4]; // Per stage, for the include guards
+    bool m_VersionSeen[4];
+    int m_Stage; // -1 before the first #shader
+    bool m_Failed;
+
+public:
+    ShaderPreprocessor(const std::vector<std::string> &defines, const AssetPack *pack = nullptr);
+
+    // Returns false (after printing why) on missing files or bad directives
+    bool Process(const std::string &filepath, ShaderProgramSource &result);
+
+    static bool ReadFile(const std::string &filepath, std::string &contents);
+
+private:
+    bool Read(const std::string &filepath, std::string &contents) const;
+    void ProcessFile(const std::string &filepath, const std::string &source, int depth);
+    int GetFileIndex(const std::string &filepath);
+    std::string GetDefineLines() const;
+};
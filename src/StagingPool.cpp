@@ -0,0 +1,134 @@
+#include "StagingPool.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    constexpr int BucketCount = 48;
+    constexpr int Unpooled = -1;
+
+    // Precedes every block, 16 bytes keep the payload aligned like malloc
+    struct alignas(16) BlockHeader
+    {
+        size_t Capacity;
+        int Bucket;
+    };
+
+    struct PoolState
+    {
+        std::mutex Mutex;
+        std::vector<BlockHeader *> FreeLists[BucketCount];
+        StagingPool::Stats Stats;
+    };
+
+    PoolState &GetState()
+    {
+        static PoolState state;
+        return state;
+    }
+
+    int GetBucket(size_t size)
+    {
+        int bucket = 0;
+        while (((size_t)1 << bucket) < size)
+            ++bucket;
+        return bucket;
+    }
+}
+
+void *StagingPool::Allocate(size_t size)
+{
+    if (size < MinPooledSize)
+    {
+        BlockHeader *header = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+        if (!header)
+            return nullptr;
+        *header = {size, Unpooled};
+        return header + 1;
+    }
+
+    int bucket = GetBucket(size);
+    PoolState &state = GetState();
+    {
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        state.Stats.Allocations++;
+        std::vector<BlockHeader *> &freeList = state.FreeLists[bucket];
+        if (!freeList.empty())
+        {
+            BlockHeader *header = freeList.back();
+            freeList.pop_back();
+            state.Stats.Reuses++;
+            state.Stats.CachedBytes -= header->Capacity;
+            return header + 1;
+        }
+    }
+    size_t capacity = (size_t)1 << bucket;
+    BlockHeader *header = (BlockHeader *)malloc(sizeof(BlockHeader) + capacity);
+    if (!header)
+        return nullptr;
+    *header = {capacity, bucket};
+    return header + 1;
+}
+
+void *StagingPool::Reallocate(void *block, size_t size)
+{
+    if (!block)
+        return Allocate(size);
+    BlockHeader *header = (BlockHeader *)block - 1;
+    if (header->Bucket != Unpooled && size <= header->Capacity)
+        return block;
+
+    void *grown = Allocate(size);
+    if (grown)
+    {
+        memcpy(grown, block, header->Capacity < size ? header->Capacity : size);
+        Free(block);
+    }
+    return grown;
+}
+
+void StagingPool::Free(void *block)
+{
+    if (!block)
+        return;
+    BlockHeader *header = (BlockHeader *)block - 1;
+    if (header->Bucket != Unpooled)
+    {
+        PoolState &state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        if (state.Stats.CachedBytes + header->Capacity <= MaxCachedBytes)
+        {
+            state.FreeLists[header->Bucket].push_back(header);
+            state.Stats.CachedBytes += header->Capacity;
+            return;
+        }
+    }
+    free(header);
+}
+
+StagingPool::Stats StagingPool::GetStats()
+{
+    PoolState &state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    return state.Stats;
+}
+
+void StagingPool::Trim()
+{
+    PoolState &state = GetState();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    for (std::vector<BlockHeader *> &freeList : state.FreeLists)
+    {
+        for (BlockHeader *header : freeList)
+            free(header);
+        freeList.clear();
+    }
+    state.Stats.CachedBytes = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Thread-safe recycler for large, short-lived CPU buffers (decoded images
+ * waiting for upload). Blocks are rounded up to a power of two and kept in
+ * per-size free lists instead of going back to malloc, up to MaxCachedBytes.
+ * stb_image allocates through here (see Texture.cpp).
+ */
+class StagingPool
+{
+public:
+    static constexpr size_t MinPooledSize = 64 * 1024; // Smaller blocks use malloc directly
+    static constexpr size_t MaxCachedBytes = 256 * 1024 * 1024;
+
+    struct Stats
+    {
+        uint Allocations = 0; // Pooled sized requests
+        uint Reuses = 0;      // Served from a free list
+        size_t CachedBytes = 0;
+    };
+
+    static void *Allocate(size_t size);
+    static void *Reallocate(void *block, size_t size);
+    static void Free(void *block);
+
+    static Stats GetStats();
+    // Returns every cached block to the system
+    static void Trim();
+};
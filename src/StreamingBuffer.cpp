@@ -0,0 +1,111 @@
+#include "StreamingBuffer.h"
+
+#include <chrono>
+
+#include "GLStateCache.h"
+#include "Profiler.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+/*
+ * Everything binds to GL_COPY_WRITE_BUFFER, which (unlike the array and
+ * element array targets) doesn't touch vertex array state
+ */
+StreamingBuffer::StreamingBuffer(uint regionSize) : m_RendererID(0), m_RegionSize(regionSize),
+                                                    m_Persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage),
+                                                    m_PersistentPointer(nullptr), m_Fences{}, m_Region(0),
+                                                    m_Cursor(0), m_MappedOffset(0), m_FenceWaitMs(0.0)
+{
+    uint size = regionSize * RegionCount;
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+    if (m_Persistent)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall(glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags));
+        GLCall(m_PersistentPointer = (unsigned char *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+    }
+    else
+    {
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW));
+    }
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    for (GLsync fence : m_Fences)
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    if (m_PersistentPointer)
+    {
+        GLStateCache::Get().BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+        GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+    }
+    GLStateCache::Get().DeleteBuffer(m_RendererID);
+}
+
+void StreamingBuffer::NextRegion()
+{
+    if (m_Persistent)
+    {
+        /* Fence the region we leave, then wait until the GPU is done with the next one */
+        GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_Region = (m_Region + 1) % RegionCount;
+        if (GLsync fence = m_Fences[m_Region])
+        {
+            PROFILE_SCOPE("StreamingBuffer::FenceWait");
+            auto start = std::chrono::steady_clock::now();
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            while (result == GL_TIMEOUT_EXPIRED) // Only flush once the fast path failed
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            m_FenceWaitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            GLCall(glDeleteSync(fence));
+            m_Fences[m_Region] = nullptr;
+        }
+    }
+    else
+    {
+        m_Region = (m_Region + 1) % RegionCount;
+        if (m_Region == 0) // Wrapped: orphan the storage instead of waiting for the GPU
+        {
+            GLStateCache::Get().BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+            GLCall(glBufferData(GL_COPY_WRITE_BUFFER, m_RegionSize * RegionCount, nullptr, GL_STREAM_DRAW));
+        }
+    }
+    m_Cursor = m_Region * m_RegionSize;
+}
+
+void *StreamingBuffer::Map(uint size, uint alignment)
+{
+    ASSERT(size <= m_RegionSize);
+    uint offset = (m_Cursor + alignment - 1) / alignment * alignment;
+    if (offset + size > (m_Region + 1) * m_RegionSize)
+    {
+        NextRegion();
+        offset = (m_Cursor + alignment - 1) / alignment * alignment;
+        /* Region starts are only aligned if the region size is, never spill into the next region */
+        ASSERT(offset + size <= (m_Region + 1) * m_RegionSize);
+    }
+    m_MappedOffset = offset;
+    m_Cursor = offset + size;
+
+    if (m_Persistent)
+        return m_PersistentPointer + offset;
+
+    GLStateCache::Get().BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    GLCall(void *pointer = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size, flags));
+    return pointer;
+}
+
+void StreamingBuffer::Unmap()
+{
+    if (m_Persistent)
+        return; // Coherent mapping, writes are visible to the next draw
+    GLStateCache::Get().BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+    GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+}
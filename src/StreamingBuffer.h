@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+enum class BufferMode
+{
+    Dynamic, // glBufferSubData into a single allocation
+    Stream   // StreamingBuffer ring, written through a mapped pointer
+};
+
+/*
+ * Ring buffer for per-frame geometry, split into RegionCount regions.
+ * With GL 4.4 / ARB_buffer_storage the whole buffer stays persistently
+ * and coherently mapped; every region gets a glFenceSync when the writer
+ * leaves it, and is only written again after the GPU passed that fence.
+ * On GL 3.3 the buffer is orphaned (glBufferData(nullptr)) whenever the
+ * ring wraps and each write maps its range unsynchronized.
+ */
+class StreamingBuffer
+{
+public:
+    static constexpr uint RegionCount = 3;
+
+private:
+    uint m_RendererID;
+    uint m_RegionSize;
+    bool m_Persistent;
+    unsigned char *m_PersistentPointer;
+    std::array<GLsync, RegionCount> m_Fences;
+    uint m_Region;       // Region being written
+    uint m_Cursor;       // Next free byte, relative to the buffer start
+    uint m_MappedOffset; // Start of the last Map
+    double m_FenceWaitMs;
+
+public:
+    // regionSize should be a multiple of every alignment passed to Map, so each region starts aligned
+    StreamingBuffer(uint regionSize);
+    ~StreamingBuffer();
+
+    // Returns memory for size bytes (at most the region size), aligned to alignment
+    void *Map(uint size, uint alignment = 4);
+    void Unmap();
+
+    inline uint GetRendererID() const { return m_RendererID; }
+    inline uint GetMappedOffset() const { return m_MappedOffset; }
+    inline bool IsPersistent() const { return m_Persistent; }
+    // Total time spent blocked on fences so far
+    inline double GetFenceWaitMs() const { return m_FenceWaitMs; }
+
+private:
+    void NextRegion();
+};
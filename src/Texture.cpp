@@ -0,0 +1,223 @@
+#include "Texture.h"
+
+#include "StagingPool.h"
+#include "MappedFile.h"
+
+/* Decoded images are staging memory: pooled, and freed right after upload */
+#define STBI_MALLOC(size) StagingPool::Allocate(size)
+#define STBI_REALLOC(block, size) StagingPool::Reallocate(block, size)
+#define STBI_FREE(block) StagingPool::Free(block)
+#define STB_IMAGE_IMPLEMENTATION
+#include "vendor/stb_image/stb_image.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+Texture::Texture(const std::string &path, MipmapMode mipmaps) : m_RendererID(0), m_FilePath(path),
+                                                                m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0),
+                                                                m_Levels(1), m_Loaded(true)
+{
+    /* The mounted pack wins, loose files are mapped the same way */
+    AssetView asset = AssetPack::FindMounted(path);
+    if (asset.IsValid())
+    {
+        Load(asset.Data, asset.Size, mipmaps);
+        return;
+    }
+    MappedFile file(path);
+    if (file.IsValid())
+        Load(file.GetData(), file.GetSize(), mipmaps);
+    else
+    {
+        std::cout << "Failed to load " << path << ": cannot open file" << std::endl;
+        Upload(nullptr, MipmapMode::None);
+    }
+}
+
+Texture::Texture(const AssetView &asset, MipmapMode mipmaps) : m_RendererID(0), m_FilePath(asset.Path),
+                                                               m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0),
+                                                               m_Levels(1), m_Loaded(true)
+{
+    Load(asset.Data, asset.Size, mipmaps);
+}
+
+void Texture::Load(const unsigned char *data, size_t size, MipmapMode mipmaps)
+{
+    /* Precompiled textures: straight from the mapping into the driver */
+    if (m_FilePath.size() > 4 && m_FilePath.compare(m_FilePath.size() - 4, 4, ".ktx") == 0)
+    {
+        KtxFile ktx;
+        std::string error;
+        if (ktx.Parse(data, size, error))
+        {
+            if (Upload(ktx))
+                return;
+        }
+        else
+            std::cout << "Failed to load " << m_FilePath << ": " << error << std::endl;
+        Upload(nullptr, MipmapMode::None);
+        return;
+    }
+
+    // Flip image vertically (OpenGL y-axis goes from bottom to top),
+    // per thread since TextureLoader decodes on workers
+    stbi_set_flip_vertically_on_load_thread(1);
+    m_LocalBuffer = stbi_load_from_memory(data, size, &m_Width, &m_Height, &m_BPP, 4);
+    if (!m_LocalBuffer)
+        std::cout << "Failed to load " << m_FilePath << ": " << stbi_failure_reason() << std::endl;
+
+    Upload(m_LocalBuffer, mipmaps);
+
+    if (m_LocalBuffer)
+        stbi_image_free(m_LocalBuffer);
+    m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(int width, int height, const unsigned char *data, MipmapMode mipmaps)
+    : m_RendererID(0), m_FilePath(), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4),
+      m_Levels(1), m_Loaded(true)
+{
+    Upload(data, mipmaps);
+}
+
+uint Texture::CreateStorage(int width, int height, int levels, uint internalFormat)
+{
+    uint rendererID = 0;
+    GLCall(glGenTextures(1, &rendererID));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, rendererID);
+
+    // Set some default parameters, otherwise OpenGL won't render the image
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+
+    /* Immutable storage lets the driver skip completeness checks at draw time */
+    if (HasImmutableStorage() && width > 0 && height > 0)
+    {
+        GLCall(glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height));
+    }
+    else if (internalFormat == GL_RGBA8)
+        for (int level = 0; level < levels; ++level)
+        {
+            // GL_RGBA8 is internal format and GL_RGBA is external format
+            GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, Mipmap::GetLevelSize(width, level),
+                                Mipmap::GetLevelSize(height, level), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        }
+    return rendererID;
+}
+
+bool Texture::HasImmutableStorage()
+{
+    return GLEW_VERSION_4_2 || GLEW_ARB_texture_storage;
+}
+
+bool Texture::IsFormatSupported(uint internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_RGBA8:
+        return true;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return GLEW_EXT_texture_compression_s3tc;
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+    }
+    return false;
+}
+
+void Texture::Upload(const unsigned char *pixels, MipmapMode mipmaps)
+{
+    if (!pixels)
+        mipmaps = MipmapMode::None;
+    m_Levels = mipmaps == MipmapMode::None ? 1 : Mipmap::GetLevelCount(m_Width, m_Height);
+    m_RendererID = CreateStorage(m_Width, m_Height, m_Levels);
+
+    if (pixels)
+    {
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+    }
+    if (mipmaps == MipmapMode::Gpu && m_Levels > 1)
+    {
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+    }
+    else if (mipmaps == MipmapMode::Cpu)
+    {
+        std::vector<size_t> offsets;
+        std::vector<unsigned char> chain = Mipmap::GenerateChain(pixels, m_Width, m_Height, offsets);
+        for (int level = 1; level < m_Levels; ++level)
+        {
+            GLCall(glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, Mipmap::GetLevelSize(m_Width, level),
+                                   Mipmap::GetLevelSize(m_Height, level), GL_RGBA, GL_UNSIGNED_BYTE,
+                                   chain.data() + offsets[level - 1]));
+        }
+    }
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool Texture::Upload(const KtxFile &ktx)
+{
+    uint format = ktx.GetInternalFormat();
+    bool rgba8 = format == GL_RGBA8 && ktx.GetFormat() == GL_RGBA && ktx.GetType() == GL_UNSIGNED_BYTE;
+    if (!IsFormatSupported(format) || (!ktx.IsCompressed() && !rgba8))
+    {
+        std::cout << "Failed to load " << m_FilePath << ": unsupported format 0x" << std::hex << format << std::dec
+                  << std::endl;
+        return false;
+    }
+
+    const std::vector<KtxFile::Level> &levels = ktx.GetLevels();
+    m_Width = ktx.GetWidth();
+    m_Height = ktx.GetHeight();
+    m_BPP = 4;
+    m_Levels = levels.size();
+    m_RendererID = CreateStorage(m_Width, m_Height, m_Levels, format);
+
+    /* Rows are already bottom up, and compressed blocks need no unpacking */
+    bool immutable = HasImmutableStorage();
+    for (int level = 0; level < m_Levels; ++level)
+    {
+        const KtxFile::Level &data = levels[level];
+        if (!ktx.IsCompressed())
+        {
+            GLCall(glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, data.Width, data.Height, GL_RGBA, GL_UNSIGNED_BYTE,
+                                   data.Data));
+        }
+        else if (immutable)
+        {
+            GLCall(glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, data.Width, data.Height, format, data.Size,
+                                             data.Data));
+        }
+        else
+        {
+            GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, format, data.Width, data.Height, 0, data.Size,
+                                          data.Data));
+        }
+    }
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void Texture::Bind(uint slot) const
+{
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
+}
+
+void Texture::Replace(uint rendererID, int width, int height, int levels)
+{
+    GLStateCache::Get().DeleteTexture(m_RendererID);
+    m_RendererID = rendererID;
+    m_Width = width;
+    m_Height = height;
+    m_Levels = levels;
+    m_Loaded = true;
+}
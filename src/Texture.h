@@ -3,8 +3,10 @@
 #include <string>
 
 #include "Util.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "vendor/stb_image/stb_image.h"
+#include "GLStateCache.h"
+#include "Mipmap.h"
+#include "KtxFile.h"
+#include "AssetPack.h"
 
 // ============================================================================
 // Class definition
@@ -12,53 +14,47 @@
 
 class Texture
 {
+    friend class TextureLoader;
+
 private:
     uint m_RendererID;
     std::string m_FilePath;
     unsigned char *m_LocalBuffer;
     int m_Width, m_Height, m_BPP;
+    int m_Levels;
+    bool m_Loaded; // False while a TextureLoader placeholder
 
 public:
-    Texture(const std::string &path);
-    ~Texture() { GLCall(glDeleteTextures(1, &m_RendererID)); };
+    // .ktx files are uploaded as stored (compressed, with their own mips),
+    // anything else is decoded with stb_image. The path is looked up in the
+    // mounted AssetPack first.
+    Texture(const std::string &path, MipmapMode mipmaps = MipmapMode::Gpu);
+    Texture(const AssetView &asset, MipmapMode mipmaps = MipmapMode::Gpu);
+    Texture(int width, int height, const unsigned char *data, MipmapMode mipmaps = MipmapMode::None); // RGBA8 pixels
+    ~Texture() { GLStateCache::Get().DeleteTexture(m_RendererID); };
 
     void Bind(uint slot = 0) const;
-    void Unbind() const { GLCall(glBindTexture(GL_TEXTURE_2D, 0)); };
+    void Unbind() const { GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0); };
 
+    inline uint GetRendererID() const { return m_RendererID; }
     inline int GetWidth() const { return m_Width; }
     inline int GetHeight() const { return m_Height; }
-};
-
-// ============================================================================
-// Implementation
-// ============================================================================
-
-Texture::Texture(const std::string &path) : m_RendererID(0), m_FilePath(path),
-                                            m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
-{
-    // Flip image vertically (OpenGL y-axis goes from bottom to top)
-    stbi_set_flip_vertically_on_load(1);
-    m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+    inline int GetLevelCount() const { return m_Levels; }
+    inline bool IsLoaded() const { return m_Loaded; }
+
+    // Creates a bound texture with room for the given levels, immutable
+    // (glTexStorage2D) where supported. Filtering is trilinear with mips.
+    // Without immutable storage compressed levels are left undefined, the
+    // caller specifies them with glCompressedTexImage2D.
+    static uint CreateStorage(int width, int height, int levels, uint internalFormat = GL_RGBA8);
+    static bool HasImmutableStorage();
+    // S3TC needs EXT_texture_compression_s3tc, ETC2 GL 4.3 or ARB_ES3_compatibility
+    static bool IsFormatSupported(uint internalFormat);
 
-    GLCall(glGenTextures(1, &m_RendererID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
-
-    // Set some default parameters, otherwise OpenGL won't render the image
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-
-    // GL_RGBA8 is internal format and GL_RGBA is external format
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
-
-    if (m_LocalBuffer)
-        stbi_image_free(m_LocalBuffer);
-}
-
-void Texture::Bind(uint slot) const
-{
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
-}
\ No newline at end of file
+private:
+    void Load(const unsigned char *data, size_t size, MipmapMode mipmaps); // Encoded file contents
+    void Upload(const unsigned char *pixels, MipmapMode mipmaps);
+    bool Upload(const KtxFile &ktx);
+    // Takes ownership of a fully uploaded texture, dropping the placeholder
+    void Replace(uint rendererID, int width, int height, int levels);
+};
@@ -0,0 +1,77 @@
+#include "TextureArray.h"
+
+#include "vendor/stb_image/stb_image.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+TextureArray::TextureArray(const std::vector<std::string> &paths) : m_RendererID(0), m_Width(0), m_Height(0),
+                                                                     m_LayerCount(paths.size())
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+    std::vector<bool> filled(m_LayerCount, false);
+    stbi_set_flip_vertically_on_load_thread(1);
+    for (int layer = 0; layer < m_LayerCount; ++layer)
+    {
+        int width, height, channels;
+        unsigned char *pixels = stbi_load(paths[layer].c_str(), &width, &height, &channels, 4);
+        if (!pixels)
+        {
+            std::cout << "Failed to load " << paths[layer] << ": " << stbi_failure_reason() << std::endl;
+            continue;
+        }
+
+        /* The first image decides the size of every layer */
+        if (m_Width == 0)
+        {
+            m_Width = width;
+            m_Height = height;
+            GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_Width, m_Height, m_LayerCount, 0, GL_RGBA,
+                                GL_UNSIGNED_BYTE, nullptr));
+        }
+        if (width == m_Width && height == m_Height)
+        {
+            GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                                   pixels));
+            filled[layer] = true;
+        }
+        else
+            std::cout << paths[layer] << " is " << width << "x" << height << ", the texture array is " << m_Width
+                      << "x" << m_Height << std::endl;
+        stbi_image_free(pixels);
+    }
+
+    /* Storage is still allocated when nothing loaded, so sampling stays defined */
+    if (m_Width == 0)
+    {
+        std::cout << "TextureArray: none of the " << m_LayerCount << " images loaded" << std::endl;
+        m_Width = m_Height = 1;
+        GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_Width, m_Height, m_LayerCount, 0, GL_RGBA,
+                            GL_UNSIGNED_BYTE, nullptr));
+    }
+    /* glTexImage3D leaves the contents undefined, clear the layers nothing was written to */
+    std::vector<unsigned char> transparent(m_Width * m_Height * 4, 0);
+    for (int layer = 0; layer < m_LayerCount; ++layer)
+    {
+        if (!filled[layer])
+        {
+            GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_Width, m_Height, 1, GL_RGBA,
+                                   GL_UNSIGNED_BYTE, transparent.data()));
+        }
+    }
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::Bind(uint slot) const
+{
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Util.h"
+#include "GLStateCache.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * A GL_TEXTURE_2D_ARRAY with one layer per image, for sets of same sized
+ * images. Unlike an atlas there is no packing and no gutter, and every
+ * layer is filtered and mipmapped on its own without bleeding into its
+ * neighbours. Images that fail to load or whose size differs from the first
+ * one are reported and their layer is left transparent; if none loads the
+ * layers are 1x1.
+ */
+class TextureArray
+{
+private:
+    uint m_RendererID;
+    int m_Width, m_Height;
+    int m_LayerCount;
+
+public:
+    TextureArray(const std::vector<std::string> &paths);
+    ~TextureArray() { GLStateCache::Get().DeleteTexture(m_RendererID); }
+
+    void Bind(uint slot = 0) const;
+
+    inline uint GetRendererID() const { return m_RendererID; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline int GetLayerCount() const { return m_LayerCount; }
+};
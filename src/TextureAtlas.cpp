@@ -0,0 +1,275 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+#include "vendor/stb_image/stb_image.h"
+
+/* imgui_draw.cpp keeps its copy static, so this one is private as well */
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "vendor/imgui/imstb_rectpack.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    const uint32_t s_Magic = 0x414c5447; // "GTLA"
+    const uint32_t s_Version = 1;
+
+    struct CacheHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t SourceHash; // Names, paths, sizes and modification times
+        int32_t PageSize;
+        int32_t Padding;
+        uint32_t RegionCount;
+        uint32_t PageCount;
+    };
+
+    struct CacheRegion
+    {
+        int32_t Page, X, Y, Width, Height;
+    };
+
+    uint64_t HashFnv1a64(const void *data, size_t size, uint64_t hash)
+    {
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    int AlignUp(int value)
+    {
+        return (value + TextureAtlas::Alignment - 1) / TextureAtlas::Alignment * TextureAtlas::Alignment;
+    }
+}
+
+TextureAtlas::TextureAtlas(int pageSize, int padding) : m_PageSize(pageSize), m_Padding(padding)
+{
+}
+
+void TextureAtlas::Add(const std::string &name, const std::string &path)
+{
+    m_Sources.push_back({name, path});
+}
+
+bool TextureAtlas::Build(const std::string &cachePath)
+{
+    auto start = std::chrono::steady_clock::now();
+    m_Stats = Stats();
+    m_Regions.assign(m_Sources.size(), AtlasRegion());
+    m_RegionIndices.clear();
+    m_Pages.clear();
+
+    std::vector<std::vector<unsigned char>> pages;
+    m_Stats.FromCache = !cachePath.empty() && LoadCache(cachePath, pages);
+    if (!m_Stats.FromCache)
+    {
+        pages.clear();
+        if (!Pack(pages))
+            return false;
+        if (!cachePath.empty())
+            SaveCache(cachePath, pages);
+    }
+
+    for (const std::vector<unsigned char> &page : pages)
+        m_Pages.push_back(std::make_unique<Texture>(m_PageSize, m_PageSize, page.data()));
+    for (uint i = 0; i < m_Sources.size(); ++i)
+        m_RegionIndices[m_Sources[i].Name] = i;
+    SetUVs();
+
+    m_Stats.BuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+const AtlasRegion *TextureAtlas::GetRegion(const std::string &name) const
+{
+    auto it = m_RegionIndices.find(name);
+    return it != m_RegionIndices.end() ? &m_Regions[it->second] : nullptr;
+}
+
+uint64_t TextureAtlas::HashSources() const
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const Source &source : m_Sources)
+    {
+        struct stat info = {};
+        stat(source.Path.c_str(), &info);
+        int64_t stamp[2] = {(int64_t)info.st_size, (int64_t)info.st_mtime};
+        hash = HashFnv1a64(source.Name.c_str(), source.Name.size() + 1, hash);
+        hash = HashFnv1a64(source.Path.c_str(), source.Path.size() + 1, hash);
+        hash = HashFnv1a64(stamp, sizeof(stamp), hash);
+    }
+    return hash;
+}
+
+bool TextureAtlas::Pack(std::vector<std::vector<unsigned char>> &pages)
+{
+    /* Decode everything first, the packer needs all sizes at once */
+    struct Image
+    {
+        unsigned char *Pixels;
+        int Width, Height;
+    };
+    std::vector<Image> images(m_Sources.size());
+    std::vector<stbrp_rect> pending;
+    bool ok = true;
+    stbi_set_flip_vertically_on_load_thread(1);
+    for (uint i = 0; i < m_Sources.size(); ++i)
+    {
+        Image &image = images[i];
+        int channels;
+        image.Pixels = stbi_load(m_Sources[i].Path.c_str(), &image.Width, &image.Height, &channels, 4);
+        if (!image.Pixels)
+        {
+            std::cout << "Failed to load " << m_Sources[i].Path << ": " << stbi_failure_reason() << std::endl;
+            ok = false;
+            continue;
+        }
+
+        stbrp_rect rect = {};
+        rect.id = i;
+        rect.w = AlignUp(image.Width + 2 * m_Padding);
+        rect.h = AlignUp(image.Height + 2 * m_Padding);
+        if (rect.w > m_PageSize || rect.h > m_PageSize)
+        {
+            std::cout << m_Sources[i].Path << " does not fit on a " << m_PageSize << " atlas page" << std::endl;
+            ok = false;
+            continue;
+        }
+        pending.push_back(rect);
+    }
+
+    /* Fill a page, then start another one with whatever did not fit */
+    std::vector<stbrp_node> nodes(m_PageSize);
+    size_t usedPixels = 0;
+    while (ok && !pending.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, m_PageSize, m_PageSize, nodes.data(), nodes.size());
+        stbrp_setup_heuristic(&context, STBRP_HEURISTIC_Skyline_BF_sortHeight); // Tighter than bottom-left
+        stbrp_pack_rects(&context, pending.data(), pending.size());
+
+        pages.emplace_back((size_t)m_PageSize * m_PageSize * 4, 0);
+        unsigned char *page = pages.back().data();
+        std::vector<stbrp_rect> rest;
+        for (const stbrp_rect &rect : pending)
+        {
+            if (!rect.was_packed)
+            {
+                rest.push_back(rect);
+                continue;
+            }
+            usedPixels += rect.w * rect.h;
+
+            /* Copy the image and extrude its border pixels into the gutter */
+            const Image &image = images[rect.id];
+            AtlasRegion &region = m_Regions[rect.id];
+            region.Page = pages.size() - 1;
+            region.X = rect.x + m_Padding;
+            region.Y = rect.y + m_Padding;
+            region.Width = image.Width;
+            region.Height = image.Height;
+            for (int y = -m_Padding; y < image.Height + m_Padding; ++y)
+            {
+                int sourceY = std::min(std::max(y, 0), image.Height - 1);
+                const unsigned char *sourceRow = image.Pixels + (size_t)sourceY * image.Width * 4;
+                unsigned char *row = page + ((size_t)(region.Y + y) * m_PageSize + region.X) * 4;
+                memcpy(row, sourceRow, image.Width * 4);
+                for (int x = 1; x <= m_Padding; ++x)
+                {
+                    memcpy(row - x * 4, sourceRow, 4);
+                    memcpy(row + (image.Width + x - 1) * 4, sourceRow + (image.Width - 1) * 4, 4);
+                }
+            }
+        }
+        pending.swap(rest);
+    }
+
+    for (Image &image : images)
+        if (image.Pixels)
+            stbi_image_free(image.Pixels);
+    if (!ok)
+        pages.clear();
+    else if (!pages.empty())
+        m_Stats.Occupancy = (float)usedPixels / ((float)pages.size() * m_PageSize * m_PageSize);
+    return ok;
+}
+
+bool TextureAtlas::LoadCache(const std::string &path, std::vector<std::vector<unsigned char>> &pages)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    CacheHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.Magic == s_Magic &&
+              header.Version == s_Version && header.SourceHash == HashSources() &&
+              header.PageSize == m_PageSize && header.Padding == m_Padding &&
+              header.RegionCount == m_Sources.size();
+    for (uint i = 0; ok && i < header.RegionCount; ++i)
+    {
+        CacheRegion entry;
+        ok = fread(&entry, sizeof(entry), 1, file) == 1 && (uint)entry.Page < header.PageCount;
+        if (ok)
+        {
+            AtlasRegion &region = m_Regions[i];
+            region.Page = entry.Page;
+            region.X = entry.X;
+            region.Y = entry.Y;
+            region.Width = entry.Width;
+            region.Height = entry.Height;
+        }
+    }
+    size_t pageBytes = (size_t)m_PageSize * m_PageSize * 4;
+    for (uint i = 0; ok && i < header.PageCount; ++i)
+    {
+        pages.emplace_back(pageBytes);
+        ok = fread(pages.back().data(), 1, pageBytes, file) == pageBytes;
+    }
+    fclose(file);
+    return ok;
+}
+
+void TextureAtlas::SaveCache(const std::string &path, const std::vector<std::vector<unsigned char>> &pages) const
+{
+    CacheHeader header = {s_Magic, s_Version, HashSources(), m_PageSize, m_Padding,
+                          (uint32_t)m_Regions.size(), (uint32_t)pages.size()};
+
+    /* Write to a temporary file first so a crash never leaves a torn cache */
+    std::string temporary = path + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (!file)
+        return;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const AtlasRegion &region : m_Regions)
+    {
+        CacheRegion entry = {(int32_t)region.Page, region.X, region.Y, region.Width, region.Height};
+        ok = ok && fwrite(&entry, sizeof(entry), 1, file) == 1;
+    }
+    for (const std::vector<unsigned char> &page : pages)
+        ok = ok && fwrite(page.data(), 1, page.size(), file) == page.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        std::cout << "Warning: failed to write " << path << std::endl;
+    }
+}
+
+void TextureAtlas::SetUVs()
+{
+    float scale = 1.0f / m_PageSize;
+    for (AtlasRegion &region : m_Regions)
+    {
+        region.UVMin = glm::vec2(region.X, region.Y) * scale;
+        region.UVMax = glm::vec2(region.X + region.Width, region.Y + region.Height) * scale;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Util.h"
+#include "Texture.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+struct AtlasRegion
+{
+    uint Page = 0;       // Index into the atlas pages
+    glm::vec2 UVMin;     // Bottom left, texture coordinates of the page
+    glm::vec2 UVMax;     // Top right
+    int X = 0, Y = 0;    // Pixel rect on the page, without the gutter
+    int Width = 0, Height = 0;
+};
+
+/*
+ * Packs many images into one or more large pages with imstb_rectpack so
+ * sprites that share a page share a texture slot. Every image gets a gutter
+ * of Padding pixels filled with its own edge pixels (linear filtering and
+ * the first mip levels never sample a neighbour), and packed rects start on
+ * 4 pixel boundaries. Build() can write the pages and rects to a cache file
+ * that is reused as long as no source image changed.
+ */
+class TextureAtlas
+{
+public:
+    static constexpr int Alignment = 4;
+
+    struct Stats
+    {
+        bool FromCache = false;
+        double BuildMs = 0.0;
+        float Occupancy = 0.0f; // Share of the page pixels covered by images and gutters
+    };
+
+private:
+    struct Source
+    {
+        std::string Name;
+        std::string Path;
+    };
+
+    int m_PageSize;
+    int m_Padding;
+    std::vector<Source> m_Sources;
+    std::vector<AtlasRegion> m_Regions; // Parallel to m_Sources once built
+    std::unordered_map<std::string, uint> m_RegionIndices;
+    std::vector<std::unique_ptr<Texture>> m_Pages;
+    Stats m_Stats;
+
+public:
+    TextureAtlas(int pageSize = 2048, int padding = 2);
+    ~TextureAtlas() {}
+
+    // Queue an image, the name is used for lookups after Build()
+    void Add(const std::string &name, const std::string &path);
+    // Packs and uploads the queued images; with a cache path the packing is
+    // skipped when the cache is up to date, and written otherwise
+    bool Build(const std::string &cachePath = "");
+
+    const AtlasRegion *GetRegion(const std::string &name) const;
+    inline const AtlasRegion &GetRegion(uint index) const { return m_Regions[index]; }
+    inline uint GetRegionCount() const { return m_Regions.size(); }
+    inline const Texture &GetPage(uint page) const { return *m_Pages[page]; }
+    inline uint GetPageCount() const { return m_Pages.size(); }
+    inline const Stats &GetStats() const { return m_Stats; }
+
+private:
+    uint64_t HashSources() const;
+    bool Pack(std::vector<std::vector<unsigned char>> &pages);
+    bool LoadCache(const std::string &path, std::vector<std::vector<unsigned char>> &pages);
+    void SaveCache(const std::string &path, const std::vector<std::vector<unsigned char>> &pages) const;
+    void SetUVs();
+};
@@ -0,0 +1,197 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "Profiler.h"
+#include "vendor/stb_image/stb_image.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+TextureLoader::TextureLoader(uint workerCount) : m_Stopping(false), m_Decoding(0), m_DecodeMs(0.0),
+                                                 m_Staging(ChunkSize)
+{
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+    for (uint i = 0; i < workerCount; ++i)
+        m_Workers.emplace_back(&TextureLoader::WorkerMain, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    for (std::thread &worker : m_Workers)
+        worker.join();
+
+    for (DecodedImage &image : m_Decoded)
+        ReleaseImage(image);
+    for (DecodedImage &image : m_Uploads)
+        ReleaseImage(image);
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string &path)
+{
+    /* Nothing to decode, the mapped blocks go straight to the driver */
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".ktx") == 0)
+    {
+        m_Stats.Requested++;
+        m_Stats.Completed++;
+        return std::make_shared<Texture>(path);
+    }
+
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>(1, 1, grey);
+    texture->m_FilePath = path;
+    texture->m_Loaded = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.push_back({path, texture});
+    }
+    m_Condition.notify_one();
+    m_Stats.Requested++;
+    return texture;
+}
+
+void TextureLoader::WorkerMain()
+{
+    // Flip image vertically (OpenGL y-axis goes from bottom to top)
+    stbi_set_flip_vertically_on_load_thread(1);
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_Stopping || !m_Requests.empty(); });
+            if (m_Stopping)
+                return;
+            request = std::move(m_Requests.front());
+            m_Requests.pop_front();
+            m_Decoding++;
+        }
+
+        /* Nobody wants the texture any more, skip the decode */
+        DecodedImage image = {request.Target, request.Path, nullptr, nullptr, 0, 0, 0, 0};
+        auto start = std::chrono::steady_clock::now();
+        if (!request.Target.expired())
+        {
+            int channels;
+            AssetView asset = AssetPack::FindMounted(request.Path);
+            if (asset.IsValid())
+                image.Pixels =
+                    stbi_load_from_memory(asset.Data, asset.Size, &image.Width, &image.Height, &channels, 4);
+            else
+                image.Pixels = stbi_load(request.Path.c_str(), &image.Width, &image.Height, &channels, 4);
+            if (!image.Pixels)
+                image.Error = stbi_failure_reason(); // Thread local in stb_image
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Decoded.push_back(std::move(image));
+        m_DecodeMs += ms;
+        m_Decoding--;
+    }
+}
+
+void TextureLoader::Update(double budgetMs)
+{
+    PROFILE_SCOPE("TextureLoader::Update");
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        while (!m_Decoded.empty())
+        {
+            m_Uploads.push_back(std::move(m_Decoded.front()));
+            m_Decoded.pop_front();
+        }
+    }
+
+    m_Stats.UploadedBytes = 0;
+    while (!m_Uploads.empty() &&
+           std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budgetMs)
+    {
+        if (!UploadChunk(m_Uploads.front()))
+        {
+            ReleaseImage(m_Uploads.front());
+            m_Uploads.pop_front();
+        }
+    }
+    m_Stats.UploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool TextureLoader::UploadChunk(DecodedImage &image)
+{
+    std::shared_ptr<Texture> texture = image.Target.lock();
+    if (!texture)
+        return false;
+    if (!image.Pixels)
+    {
+        std::cout << "Failed to load " << image.Path << ": " << (image.Error ? image.Error : "unknown error") << std::endl;
+        m_Stats.Failed++;
+        return false;
+    }
+
+    GLStateCache &cache = GLStateCache::Get();
+    if (!image.RendererID)
+        image.RendererID =
+            Texture::CreateStorage(image.Width, image.Height, Mipmap::GetLevelCount(image.Width, image.Height));
+
+    /* Copy as many whole rows as fit in a chunk into the ring, then upload from it */
+    uint rowSize = image.Width * 4;
+    int rows = std::min<int>(std::max<uint>(1, ChunkSize / rowSize), image.Height - image.RowsUploaded);
+    uint size = rows * rowSize;
+    void *staging = m_Staging.Map(size, 4);
+    memcpy(staging, image.Pixels + (size_t)image.RowsUploaded * rowSize, size);
+    m_Staging.Unmap();
+
+    cache.BindTexture(GL_TEXTURE_2D, image.RendererID);
+    cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Staging.GetRendererID());
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, image.RowsUploaded, image.Width, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                           (const void *)(uintptr_t)m_Staging.GetMappedOffset()));
+    cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // Client pointer uploads elsewhere expect no PBO
+    image.RowsUploaded += rows;
+    m_Stats.UploadedBytes += size;
+
+    if (image.RowsUploaded < image.Height)
+        return true;
+    /* Same chain Texture(path) builds; one more GPU pass, no extra upload */
+    int levels = Mipmap::GetLevelCount(image.Width, image.Height);
+    if (levels > 1)
+    {
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+    }
+    texture->Replace(image.RendererID, image.Width, image.Height, levels);
+    image.RendererID = 0;
+    m_Stats.Completed++;
+    return false;
+}
+
+void TextureLoader::ReleaseImage(DecodedImage &image)
+{
+    if (image.Pixels)
+        stbi_image_free(image.Pixels);
+    image.Pixels = nullptr;
+    if (image.RendererID)
+        GLStateCache::Get().DeleteTexture(image.RendererID);
+    image.RendererID = 0;
+}
+
+uint TextureLoader::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Requests.size() + m_Decoding + m_Decoded.size() + m_Uploads.size();
+}
+
+TextureLoader::Stats TextureLoader::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.DecodeMs = m_DecodeMs;
+    return m_Stats;
+}
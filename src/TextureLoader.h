@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Texture.h"
+#include "StreamingBuffer.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+/*
+ * Loads textures without stalling the render thread. Load() returns at once
+ * with a 1x1 placeholder; worker threads decode the file into StagingPool
+ * memory, and Update() (render thread, once a frame) streams the pixels
+ * through a pixel unpack StreamingBuffer in ChunkSize pieces until the
+ * frame's time budget is used up. Once the last row is in, the finished
+ * texture replaces the placeholder inside the same Texture object.
+ */
+class TextureLoader
+{
+public:
+    static constexpr uint ChunkSize = 1024 * 1024; // Bytes per glTexSubImage2D
+
+    struct Stats
+    {
+        uint Requested = 0;
+        uint Completed = 0;
+        uint Failed = 0;
+        double DecodeMs = 0.0;    // Summed over the workers
+        double UploadMs = 0.0;    // Render thread, last Update()
+        uint UploadedBytes = 0;   // Last Update()
+    };
+
+private:
+    struct Request
+    {
+        std::string Path;
+        std::weak_ptr<Texture> Target;
+    };
+
+    struct DecodedImage
+    {
+        std::weak_ptr<Texture> Target;
+        std::string Path;
+        unsigned char *Pixels; // RGBA8 in StagingPool memory, nullptr if decoding failed
+        const char *Error;
+        int Width, Height;
+        uint RendererID;       // Created by the first chunk
+        int RowsUploaded;
+    };
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping;
+    std::deque<Request> m_Requests;     // Waiting for a worker
+    std::deque<DecodedImage> m_Decoded; // Waiting for the render thread
+    std::atomic<uint> m_Decoding;
+    double m_DecodeMs;                  // Guarded by m_Mutex
+
+    std::deque<DecodedImage> m_Uploads; // Render thread only, the front one is in progress
+    StreamingBuffer m_Staging;
+    Stats m_Stats;
+
+public:
+    TextureLoader(uint workerCount = 0); // 0 picks one less than the hardware threads
+    ~TextureLoader();
+
+    // .ktx files are small and need no decode, they load synchronously
+    std::shared_ptr<Texture> Load(const std::string &path);
+    void Update(double budgetMs = 2.0);
+
+    // Textures requested but not uploaded yet
+    uint GetPendingCount();
+    Stats GetStats();
+
+private:
+    void WorkerMain();
+    // Returns false when the image is finished (or dropped)
+    bool UploadChunk(DecodedImage &image);
+    static void ReleaseImage(DecodedImage &image);
+};
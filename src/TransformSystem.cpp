@@ -0,0 +1,351 @@
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace
+{
+    constexpr uint LocalGrain = 16384; // Transforms per job, a multiple of every lane width
+    constexpr uint WorldGrain = 4096;
+
+    /* The widest float vector the build targets, so UpdateLocal() is written once */
+#if defined(__AVX__)
+    struct Lanes
+    {
+        using Type = __m256;
+        static constexpr uint Width = 8;
+        static Type Load(const float *p) { return _mm256_loadu_ps(p); }
+        static void Store(float *p, Type v) { _mm256_storeu_ps(p, v); }
+        static Type Set(float f) { return _mm256_set1_ps(f); }
+        static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+        static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+        static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    };
+#elif defined(__SSE2__)
+    struct Lanes
+    {
+        using Type = __m128;
+        static constexpr uint Width = 4;
+        static Type Load(const float *p) { return _mm_loadu_ps(p); }
+        static void Store(float *p, Type v) { _mm_storeu_ps(p, v); }
+        static Type Set(float f) { return _mm_set1_ps(f); }
+        static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+        static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+        static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    };
+#else
+    struct Lanes
+    {
+        using Type = float;
+        static constexpr uint Width = 1;
+        static Type Load(const float *p) { return *p; }
+        static void Store(float *p, Type v) { *p = v; }
+        static Type Set(float f) { return f; }
+        static Type Add(Type a, Type b) { return a + b; }
+        static Type Sub(Type a, Type b) { return a - b; }
+        static Type Mul(Type a, Type b) { return a * b; }
+    };
+#endif
+
+    bool AnyDirty(const uint8_t *flags)
+    {
+        for (uint i = 0; i < Lanes::Width; ++i)
+            if (flags[i])
+                return true;
+        return false;
+    }
+}
+
+TransformSystem::TransformSystem() : m_Count(0), m_HierarchyChanged(false)
+{
+}
+
+void TransformSystem::Reserve(uint count)
+{
+    uint padded = (count + Padding - 1) / Padding * Padding;
+    for (std::vector<float> &position : m_Position)
+        position.reserve(padded);
+    for (std::vector<float> &rotation : m_Rotation)
+        rotation.reserve(padded);
+    for (std::vector<float> &scale : m_Scale)
+        scale.reserve(padded);
+    for (std::vector<float> &local : m_Local)
+        local.reserve(padded);
+    m_Parent.reserve(padded);
+    m_LocalDirty.reserve(padded);
+    m_WorldDirty.reserve(padded);
+    m_World.reserve(padded);
+    m_IDs.reserve(padded);
+    m_Slots.reserve(count);
+    m_ParentIDs.reserve(count);
+}
+
+void TransformSystem::Resize(uint slots)
+{
+    uint padded = (slots + Padding - 1) / Padding * Padding;
+    for (std::vector<float> &position : m_Position)
+        position.resize(padded, 0.0f);
+    for (uint i = 0; i < 4; ++i)
+        m_Rotation[i].resize(padded, i == 3 ? 1.0f : 0.0f);
+    for (std::vector<float> &scale : m_Scale)
+        scale.resize(padded, 1.0f);
+    for (uint i = 0; i < 9; ++i)
+        m_Local[i].resize(padded, i % 4 == 0 ? 1.0f : 0.0f); // 0, 4 and 8 are the diagonal
+    m_Parent.resize(padded, NoParent);
+    m_LocalDirty.resize(padded, 0);
+    m_WorldDirty.resize(padded, 0);
+    m_World.resize(padded, glm::mat4(1.0f));
+    m_IDs.resize(padded, NoParent);
+}
+
+TransformID TransformSystem::Create(TransformID parent)
+{
+    ASSERT(parent == NoParent || parent < m_Count);
+    TransformID id = m_Count++;
+    Resize(m_Count);
+
+    /* Appended at the end for now, Update() moves it to its level */
+    uint slot = id;
+    m_Slots.push_back(slot);
+    m_IDs[slot] = id;
+    m_ParentIDs.push_back(parent);
+    m_Parent[slot] = parent == NoParent ? NoParent : m_Slots[parent];
+    m_LocalDirty[slot] = 1;
+    m_HierarchyChanged = true;
+    return id;
+}
+
+void TransformSystem::SetParent(TransformID id, TransformID parent)
+{
+    ASSERT(parent == NoParent || (parent < m_Count && parent != id));
+    m_ParentIDs[id] = parent;
+    m_Parent[m_Slots[id]] = parent == NoParent ? NoParent : m_Slots[parent];
+    MarkDirty(id);
+    m_HierarchyChanged = true;
+}
+
+void TransformSystem::SetPosition(TransformID id, const glm::vec3 &position)
+{
+    uint slot = m_Slots[id];
+    m_Position[0][slot] = position.x;
+    m_Position[1][slot] = position.y;
+    m_Position[2][slot] = position.z;
+    m_LocalDirty[slot] = 1;
+}
+
+void TransformSystem::SetRotation(TransformID id, float angle, const glm::vec3 &axis)
+{
+    float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+    float s = length > 0.0f ? std::sin(angle * 0.5f) / length : 0.0f;
+    uint slot = m_Slots[id];
+    m_Rotation[0][slot] = axis.x * s;
+    m_Rotation[1][slot] = axis.y * s;
+    m_Rotation[2][slot] = axis.z * s;
+    m_Rotation[3][slot] = std::cos(angle * 0.5f);
+    m_LocalDirty[slot] = 1;
+}
+
+void TransformSystem::SetScale(TransformID id, const glm::vec3 &scale)
+{
+    uint slot = m_Slots[id];
+    m_Scale[0][slot] = scale.x;
+    m_Scale[1][slot] = scale.y;
+    m_Scale[2][slot] = scale.z;
+    m_LocalDirty[slot] = 1;
+}
+
+void TransformSystem::SortByDepth()
+{
+    /* Depth of every transform, walking up until a known depth (parents may come later after SetParent) */
+    const uint unknown = ~0u;
+    std::vector<uint> depths(m_Count, unknown);
+    std::vector<TransformID> path;
+    uint levelCount = 0;
+    for (TransformID id = 0; id < m_Count; ++id)
+    {
+        TransformID current = id;
+        while (current != NoParent && depths[current] == unknown)
+        {
+            path.push_back(current);
+            ASSERT(path.size() <= m_Count); // A cycle
+            current = m_ParentIDs[current];
+        }
+        uint depth = current == NoParent ? 0 : depths[current] + 1;
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+            depths[*it] = depth++;
+        path.clear();
+        levelCount = std::max(levelCount, depths[id] + 1);
+    }
+
+    /* Counting sort, stable so siblings keep their creation order */
+    m_Levels.assign(levelCount + 1, 0);
+    for (uint depth : depths)
+        m_Levels[depth + 1]++;
+    for (uint level = 0; level < levelCount; ++level)
+        m_Levels[level + 1] += m_Levels[level];
+    std::vector<uint> slots(m_Count);
+    std::vector<uint> next(m_Levels.begin(), m_Levels.end() - 1);
+    for (TransformID id = 0; id < m_Count; ++id)
+        slots[id] = next[depths[id]]++;
+
+    /* Move everything to its new slot; a new hierarchy is recomputed from scratch */
+    auto permute = [this, &slots](auto &array) {
+        auto sorted = array;
+        for (TransformID id = 0; id < m_Count; ++id)
+            sorted[slots[id]] = array[m_Slots[id]];
+        array.swap(sorted);
+    };
+    for (std::vector<float> &position : m_Position)
+        permute(position);
+    for (std::vector<float> &rotation : m_Rotation)
+        permute(rotation);
+    for (std::vector<float> &scale : m_Scale)
+        permute(scale);
+    permute(m_World);
+    for (TransformID id = 0; id < m_Count; ++id)
+    {
+        TransformID parent = m_ParentIDs[id];
+        m_Parent[slots[id]] = parent == NoParent ? NoParent : slots[parent];
+        m_IDs[slots[id]] = id;
+        m_LocalDirty[slots[id]] = 1;
+    }
+    m_Slots.swap(slots);
+    m_HierarchyChanged = false;
+}
+
+void TransformSystem::Update(JobSystem *jobs)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (m_HierarchyChanged)
+        SortByDepth();
+    m_Stats.LocalUpdates = m_Stats.WorldUpdates = 0;
+
+    /* Locals have no dependencies, the whole (padded) range at once */
+    uint padded = (m_Count + Padding - 1) / Padding * Padding;
+    if (jobs && padded > LocalGrain)
+    {
+        std::atomic<uint> count(0);
+        jobs->ParallelFor(padded, LocalGrain, [this, &count](uint begin, uint end, uint) {
+            count += UpdateLocal(begin, end);
+        });
+        m_Stats.LocalUpdates = count;
+    }
+    else
+        m_Stats.LocalUpdates = UpdateLocal(0, padded);
+
+    /* World matrices one level after the other, a level only reads the one above */
+    for (uint level = 0; level + 1 < m_Levels.size(); ++level)
+    {
+        uint begin = m_Levels[level], end = m_Levels[level + 1];
+        if (jobs && end - begin > WorldGrain)
+        {
+            std::atomic<uint> count(0);
+            jobs->ParallelFor(end - begin, WorldGrain, [this, &count, begin](uint first, uint last, uint) {
+                count += UpdateWorld(begin + first, begin + last);
+            });
+            m_Stats.WorldUpdates += count;
+        }
+        else
+            m_Stats.WorldUpdates += UpdateWorld(begin, end);
+    }
+    m_Stats.UpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint TransformSystem::UpdateLocal(uint begin, uint end)
+{
+    using V = Lanes::Type;
+    const V one = Lanes::Set(1.0f), two = Lanes::Set(2.0f);
+    uint updated = 0;
+    for (uint i = begin; i < end; i += Lanes::Width)
+    {
+        /* Recomputing the clean lanes of a dirty batch gives the same matrices */
+        if (!AnyDirty(&m_LocalDirty[i]))
+            continue;
+        updated += Lanes::Width;
+
+        V x = Lanes::Load(&m_Rotation[0][i]), y = Lanes::Load(&m_Rotation[1][i]);
+        V z = Lanes::Load(&m_Rotation[2][i]), w = Lanes::Load(&m_Rotation[3][i]);
+        V sx = Lanes::Load(&m_Scale[0][i]), sy = Lanes::Load(&m_Scale[1][i]), sz = Lanes::Load(&m_Scale[2][i]);
+
+        V xx = Lanes::Mul(x, x), yy = Lanes::Mul(y, y), zz = Lanes::Mul(z, z);
+        V xy = Lanes::Mul(x, y), xz = Lanes::Mul(x, z), yz = Lanes::Mul(y, z);
+        V xw = Lanes::Mul(x, w), yw = Lanes::Mul(y, w), zw = Lanes::Mul(z, w);
+
+        /* Rotation matrix of the quaternion, each column scaled */
+        Lanes::Store(&m_Local[0][i], Lanes::Mul(Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(yy, zz))), sx));
+        Lanes::Store(&m_Local[1][i], Lanes::Mul(Lanes::Mul(two, Lanes::Add(xy, zw)), sx));
+        Lanes::Store(&m_Local[2][i], Lanes::Mul(Lanes::Mul(two, Lanes::Sub(xz, yw)), sx));
+        Lanes::Store(&m_Local[3][i], Lanes::Mul(Lanes::Mul(two, Lanes::Sub(xy, zw)), sy));
+        Lanes::Store(&m_Local[4][i], Lanes::Mul(Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(xx, zz))), sy));
+        Lanes::Store(&m_Local[5][i], Lanes::Mul(Lanes::Mul(two, Lanes::Add(yz, xw)), sy));
+        Lanes::Store(&m_Local[6][i], Lanes::Mul(Lanes::Mul(two, Lanes::Add(xz, yw)), sz));
+        Lanes::Store(&m_Local[7][i], Lanes::Mul(Lanes::Mul(two, Lanes::Sub(yz, xw)), sz));
+        Lanes::Store(&m_Local[8][i], Lanes::Mul(Lanes::Sub(one, Lanes::Mul(two, Lanes::Add(xx, yy))), sz));
+    }
+    return updated;
+}
+
+uint TransformSystem::UpdateWorld(uint begin, uint end)
+{
+    uint updated = 0;
+    for (uint i = begin; i < end; ++i)
+    {
+        uint parent = m_Parent[i];
+        bool dirty = m_LocalDirty[i] || (parent != NoParent && m_WorldDirty[parent]);
+        m_WorldDirty[i] = dirty;
+        m_LocalDirty[i] = 0;
+        if (!dirty)
+            continue;
+        updated++;
+
+        float *world = &m_World[i][0][0];
+        const float l[9] = {m_Local[0][i], m_Local[1][i], m_Local[2][i], m_Local[3][i], m_Local[4][i],
+                            m_Local[5][i], m_Local[6][i], m_Local[7][i], m_Local[8][i]};
+        const float t[3] = {m_Position[0][i], m_Position[1][i], m_Position[2][i]};
+        if (parent == NoParent)
+        {
+            const float local[16] = {l[0], l[1], l[2], 0.0f, l[3], l[4], l[5], 0.0f,
+                                     l[6], l[7], l[8], 0.0f, t[0], t[1], t[2], 1.0f};
+            std::memcpy(world, local, sizeof(local));
+            continue;
+        }
+
+        /* Parent * local, the local matrix is affine: columns are combinations of the parent's */
+        const float *p = &m_World[parent][0][0];
+#if defined(__SSE2__)
+        __m128 p0 = _mm_loadu_ps(p), p1 = _mm_loadu_ps(p + 4), p2 = _mm_loadu_ps(p + 8), p3 = _mm_loadu_ps(p + 12);
+        for (uint column = 0; column < 3; ++column)
+        {
+            __m128 c = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(l[3 * column])),
+                                             _mm_mul_ps(p1, _mm_set1_ps(l[3 * column + 1]))),
+                                  _mm_mul_ps(p2, _mm_set1_ps(l[3 * column + 2])));
+            _mm_storeu_ps(world + 4 * column, c);
+        }
+        __m128 c3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(t[0])), _mm_mul_ps(p1, _mm_set1_ps(t[1]))),
+                               _mm_add_ps(_mm_mul_ps(p2, _mm_set1_ps(t[2])), p3));
+        _mm_storeu_ps(world + 12, c3);
+#else
+        for (uint row = 0; row < 4; ++row)
+        {
+            for (uint column = 0; column < 3; ++column)
+                world[4 * column + row] = p[row] * l[3 * column] + p[4 + row] * l[3 * column + 1] +
+                                          p[8 + row] * l[3 * column + 2];
+            world[12 + row] = p[row] * t[0] + p[4 + row] * t[1] + p[8 + row] * t[2] + p[12 + row];
+        }
+#endif
+    }
+    return updated;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Util.h"
+#include "JobSystem.h"
+
+// ============================================================================
+// Class definition
+// ============================================================================
+
+using TransformID = uint; // Stable handle, in creation order
+
+/*
+ * Parent/child transforms. Local translation, rotation (a quaternion) and
+ * scale live in structure of arrays form, sorted by hierarchy depth, so a
+ * level's parents are all finished before the level starts. Update()
+ * recomputes:
+ *
+ * 1. the local matrices of transforms whose TRS changed, 4 (SSE) or 8 (AVX)
+ *    at a time straight from the arrays;
+ * 2. world = parent world * local, level by level, for the changed
+ *    transforms and everything below them.
+ *
+ * Both passes can be split across the JobSystem. Transforms are never
+ * destroyed, and SetParent() must not create a cycle.
+ */
+class TransformSystem
+{
+public:
+    static constexpr TransformID NoParent = ~0u;
+
+    struct Stats
+    {
+        uint LocalUpdates = 0; // Local matrices recomputed, including clean lanes of a dirty batch
+        uint WorldUpdates = 0; // World matrices recomputed
+        double UpdateMs = 0.0;
+    };
+
+private:
+    /* Indexed by slot (depth order), the arrays are padded to a multiple of 8 */
+    std::vector<float> m_Position[3];
+    std::vector<float> m_Rotation[4]; // x, y, z, w
+    std::vector<float> m_Scale[3];
+    std::vector<float> m_Local[9];    // Upper 3x3 of the local matrix, column major
+    std::vector<uint> m_Parent;       // Slot, or NoParent
+    std::vector<uint8_t> m_LocalDirty;
+    std::vector<uint8_t> m_WorldDirty;
+    std::vector<glm::mat4> m_World;
+    std::vector<uint> m_Levels; // First slot of each depth, plus the end
+
+    std::vector<uint> m_Slots; // By TransformID
+    std::vector<uint> m_IDs;   // By slot
+    std::vector<uint> m_ParentIDs; // By TransformID, the source of truth for the sort
+    uint m_Count;
+    bool m_HierarchyChanged;
+    Stats m_Stats;
+
+public:
+    TransformSystem();
+    ~TransformSystem() {}
+
+    TransformID Create(TransformID parent = NoParent);
+    void SetParent(TransformID id, TransformID parent);
+    void Reserve(uint count);
+
+    void SetPosition(TransformID id, const glm::vec3 &position);
+    // Angle in radians around axis, like glm::rotate
+    void SetRotation(TransformID id, float angle, const glm::vec3 &axis);
+    void SetScale(TransformID id, const glm::vec3 &scale);
+
+    // jobs splits both passes into chunks, nullptr runs on the calling thread
+    void Update(JobSystem *jobs = nullptr);
+    // Valid after Update()
+    inline const glm::mat4 &GetWorld(TransformID id) const { return m_World[m_Slots[id]]; }
+
+    inline uint GetCount() const { return m_Count; }
+    inline uint GetDepth() const { return m_Levels.empty() ? 0 : m_Levels.size() - 1; }
+    inline const Stats &GetStats() const { return m_Stats; }
+
+private:
+    static constexpr uint Padding = 8;
+
+    void Resize(uint slots);
+    void SortByDepth();
+    uint UpdateLocal(uint begin, uint end); // Returns the matrices recomputed
+    uint UpdateWorld(uint begin, uint end);
+    inline void MarkDirty(TransformID id) { m_LocalDirty[m_Slots[id]] = 1; }
+};
@@ -0,0 +1,94 @@
+#include "UniformBuffer.h"
+
+#include "GLStateCache.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+/*
+ * std140: scalars align to 4, vec2 to 8, vec3/vec4 to 16, and every array
+ * element (matrix columns included) is padded to a multiple of 16 bytes
+ */
+uint UniformBlockLayout::PushMember(uint alignment, uint size, uint count)
+{
+    if (count > 1)
+    {
+        alignment = (alignment + 15) / 16 * 16;
+        size = (size + 15) / 16 * 16 * count;
+    }
+    uint offset = (m_Size + alignment - 1) / alignment * alignment;
+    m_Size = offset + size;
+    return offset;
+}
+
+template <>
+uint UniformBlockLayout::Push<float>(uint count)
+{
+    return PushMember(4, 4, count);
+}
+
+template <>
+uint UniformBlockLayout::Push<int>(uint count)
+{
+    return PushMember(4, 4, count);
+}
+
+template <>
+uint UniformBlockLayout::Push<glm::vec2>(uint count)
+{
+    return PushMember(8, 8, count);
+}
+
+template <>
+uint UniformBlockLayout::Push<glm::vec3>(uint count)
+{
+    return PushMember(16, 12, count);
+}
+
+template <>
+uint UniformBlockLayout::Push<glm::vec4>(uint count)
+{
+    return PushMember(16, 16, count);
+}
+
+template <>
+uint UniformBlockLayout::Push<glm::mat4>(uint count)
+{
+    return PushMember(16, 64, count);
+}
+
+UniformBuffer::UniformBuffer(uint size) : m_RendererID(0), m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    GLStateCache::Get().DeleteBuffer(m_RendererID);
+}
+
+void UniformBuffer::SetData(const void *data, uint size, uint offset)
+{
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::BindBase(uint binding) const
+{
+    GLStateCache::Get().BindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+}
+
+void UniformBuffer::BindRange(uint binding, uint offset, uint size) const
+{
+    GLStateCache::Get().BindBufferRange(GL_UNIFORM_BUFFER, binding, m_RendererID, offset, size);
+}
+
+uint UniformBuffer::GetOffsetAlignment()
+{
+    GLint alignment = 256;
+    GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    return alignment;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Util.h"
+
+// ============================================================================
+// Class definitions
+// ============================================================================
+
+// Binding points shared by every shader (blocks are bound by name in Shader)
+enum UniformBinding : uint
+{
+    CameraBinding = 0,  // uniform Camera { mat4 u_ViewProj; }
+    ObjectsBinding = 1  // uniform Objects { mat4 u_Models[...]; }
+};
+
+// Per-frame camera block, matches the std140 layout of "Camera"
+struct CameraBlock
+{
+    glm::mat4 ViewProj;
+};
+
+/*
+ * Computes std140 offsets, the same way VertexBufferLayout computes vertex
+ * attribute offsets. Push returns the offset of the pushed member.
+ */
+class UniformBlockLayout
+{
+private:
+    uint m_Size;
+
+public:
+    UniformBlockLayout() : m_Size(0) {}
+
+    template <typename T>
+    uint Push(uint count = 1); // count > 1 pushes an array
+    // Block size, rounded up to a vec4 as std140 does for the block
+    inline uint GetSize() const { return (m_Size + 15) / 16 * 16; }
+
+private:
+    uint PushMember(uint alignment, uint size, uint count);
+};
+
+class UniformBuffer
+{
+private:
+    uint m_RendererID;
+    uint m_Size;
+
+public:
+    UniformBuffer(uint size);
+    ~UniformBuffer();
+
+    void SetData(const void *data, uint size, uint offset = 0);
+    void BindBase(uint binding) const;
+    void BindRange(uint binding, uint offset, uint size) const;
+
+    inline uint GetSize() const { return m_Size; }
+    // BindRange offsets must be multiples of this
+    static uint GetOffsetAlignment();
+};
@@ -1,5 +1,10 @@
 #include "Util.h"
 
+bool g_GLDebugOutput = false;
+bool g_GLDebugSynchronous = false;
+bool g_GLErrorReported = false;
+GLCallSite g_GLLastCall = {"", "", 0};
+
 void GLClearError()
 {
     while (glGetError() != GL_NO_ERROR);
@@ -9,8 +14,72 @@ bool GLLogCall(const char *function, const char *file, int line)
 {
     while (GLenum error = glGetError())
     {
-        return false;
         std::cout << "[OpenGL Error] (" << error << "):" << function << " " << file << ":" << line << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static const char *GLDebugSourceName(GLenum source)
+{
+    switch (source)
+    {
+    case GL_DEBUG_SOURCE_API:
+        return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+        return "Window System";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:
+        return "Shader Compiler";
+    case GL_DEBUG_SOURCE_THIRD_PARTY:
+        return "Third Party";
+    case GL_DEBUG_SOURCE_APPLICATION:
+        return "Application";
+    }
+    return "Other";
+}
+
+static const char *GLDebugSeverityName(GLenum severity)
+{
+    switch (severity)
+    {
+    case GL_DEBUG_SEVERITY_HIGH:
+        return "High";
+    case GL_DEBUG_SEVERITY_MEDIUM:
+        return "Medium";
+    case GL_DEBUG_SEVERITY_LOW:
+        return "Low";
     }
+    return "Notification";
+}
+
+static void GLAPIENTRY GLDebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                              GLsizei length, const GLchar *message, const void *userParam)
+{
+    std::cout << "[OpenGL Debug] (" << GLDebugSourceName(source) << ", " << GLDebugSeverityName(severity)
+              << ", " << id << "): " << message << std::endl;
+    /* Asynchronous callbacks may run on a driver thread, leave GLCall's state alone */
+    if (!g_GLDebugSynchronous)
+        return;
+    std::cout << "    in " << g_GLLastCall.Function << " " << g_GLLastCall.File << ":" << g_GLLastCall.Line << std::endl;
+    if (type == GL_DEBUG_TYPE_ERROR)
+        g_GLErrorReported = true;
+}
+
+bool GLInitDebugOutput(bool synchronous)
+{
+    if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+        return false; // Keep polling glGetError in GLCall
+
+    /* Set before the callback can run, it only reads the flag afterwards */
+    g_GLDebugSynchronous = synchronous;
+    glEnable(GL_DEBUG_OUTPUT);
+    if (synchronous) // Exact call sites, at the cost of serializing the driver
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(GLDebugMessageCallback, nullptr);
+    // Drop the (very chatty) notifications, e.g. buffer placement hints
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    g_GLDebugOutput = true;
     return true;
-}
\ No newline at end of file
+}
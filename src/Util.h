@@ -6,11 +6,62 @@
 #define ASSERT(x) \
     if (!(x))     \
         __builtin_trap();
-#define GLCall(x)   \
-    GLClearError(); \
-    x;              \
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__));
+
+/*
+ * Release builds (NDEBUG) compile GLCall down to the bare call.
+ * Debug builds either let the synchronous KHR_debug callback report errors
+ * (GLCall only records the call site) or, without KHR_debug, poll
+ * glGetError around x.
+ */
+#ifdef NDEBUG
+#define GLCall(x) x;
+#else
+#define GLCall(x)                        \
+    GLBeginCall(#x, __FILE__, __LINE__); \
+    x;                                   \
+    ASSERT(GLEndCall(#x, __FILE__, __LINE__));
+#endif
+
+struct GLCallSite
+{
+    const char *Function;
+    const char *File;
+    int Line;
+};
+
+extern bool g_GLDebugOutput;      // True once the debug callback is installed
+extern bool g_GLDebugSynchronous; // Callback runs inside the failing call, on the GL thread
+extern bool g_GLErrorReported;    // Set by a synchronous callback on GL_DEBUG_TYPE_ERROR
+extern GLCallSite g_GLLastCall;   // Only tracked when synchronous
 
 void GLClearError();
 
-bool GLLogCall(const char *function, const char *file, int line);
\ No newline at end of file
+bool GLLogCall(const char *function, const char *file, int line);
+
+/*
+ * Installs the KHR_debug callback (GL 4.3), returns false if unsupported.
+ * Synchronous output is what GLCall's checks need: the callback runs in the
+ * failing call, so the error is reported at that GLCall. Asynchronous
+ * output only logs messages (the driver may call back from its own thread)
+ * and GLCall never asserts on them.
+ */
+bool GLInitDebugOutput(bool synchronous = true);
+
+inline void GLBeginCall(const char *function, const char *file, int line)
+{
+    if (!g_GLDebugOutput)
+        GLClearError();
+    else if (g_GLDebugSynchronous)
+        g_GLLastCall = {function, file, line};
+}
+
+inline bool GLEndCall(const char *function, const char *file, int line)
+{
+    if (!g_GLDebugOutput)
+        return GLLogCall(function, file, line);
+    if (!g_GLDebugSynchronous)
+        return true; // Log only
+    bool ok = !g_GLErrorReported;
+    g_GLErrorReported = false;
+    return ok;
+}
@@ -0,0 +1,24 @@
+#include "VertexArray.h"
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+void VertexArray::AddBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout)
+{
+    Bind();
+    vb.Bind();
+    const std::vector<VertexBufferElement> &elements = layout.GetElements();
+    intptr_t offset = 0;
+    for (uint i = 0; i < elements.size(); ++i, ++m_AttribCount)
+    {
+        const VertexBufferElement &element = elements[i];
+        GLCall(glEnableVertexAttribArray(m_AttribCount)); // Matches layout(location = ...) in the shader
+        GLCall(glVertexAttribPointer(m_AttribCount, element.count, element.type, element.normalized, layout.GetStride(), (const void *)offset));
+        if (element.divisor)
+        {
+            GLCall(glVertexAttribDivisor(m_AttribCount, element.divisor)); // Per instance attribute
+        }
+        offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+    }
+}
@@ -0,0 +1,57 @@
+#include "VertexBuffer.h"
+
+#include <cstring>
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+VertexBuffer::VertexBuffer(const void *data, uint size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));              // Generate vertex buffer ID
+    Bind();                                               // Assign buffer type Array
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+}
+
+VertexBuffer::VertexBuffer(uint size, BufferMode mode)
+{
+    if (mode == BufferMode::Stream)
+    {
+        m_Stream = std::make_unique<StreamingBuffer>(size);
+        m_RendererID = m_Stream->GetRendererID();
+        return;
+    }
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Bind();
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW)); // Allocate only
+}
+
+VertexBuffer::~VertexBuffer()
+{
+    if (!m_Stream) // The stream owns its buffer
+        GLStateCache::Get().DeleteBuffer(m_RendererID);
+}
+
+uint VertexBuffer::SetData(const void *data, uint size, uint alignment)
+{
+    if (m_Stream)
+    {
+        memcpy(Map(size, alignment), data, size);
+        Unmap();
+        return m_Stream->GetMappedOffset();
+    }
+    Bind();
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    return 0;
+}
+
+void *VertexBuffer::Map(uint size, uint alignment)
+{
+    ASSERT(m_Stream);
+    return m_Stream->Map(size, alignment);
+}
+
+void VertexBuffer::Unmap()
+{
+    m_Stream->Unmap();
+}
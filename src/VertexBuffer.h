@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+
 #include "Util.h"
+#include "GLStateCache.h"
+#include "StreamingBuffer.h"
 
 // ============================================================================
 // Class definition
@@ -10,22 +14,24 @@ class VertexBuffer
 {
 private:
     uint m_RendererID;
+    std::unique_ptr<StreamingBuffer> m_Stream; // Only in BufferMode::Stream
 
 public:
     VertexBuffer(const void *data, uint size);
-    ~VertexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+    // Dynamic: filled later with SetData. Stream: size is the per-region capacity
+    VertexBuffer(uint size, BufferMode mode = BufferMode::Dynamic);
+    ~VertexBuffer();
 
-    void Bind() const { GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID)); }
-    void Unbind() const { GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0)); }
-};
+    void Bind() const { GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID); }
+    void Unbind() const { GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0); }
 
-// ============================================================================
-// Implementation
-// ============================================================================
+    // Returns the byte offset the data starts at: 0, or in stream mode a new ring position. The
+    // vertex array reads from offset 0, so pass the stride and draw with base vertex offset / stride
+    uint SetData(const void *data, uint size, uint alignment = 4);
 
-VertexBuffer::VertexBuffer(const void *data, uint size)
-{
-    GLCall(glGenBuffers(1, &m_RendererID));              // Generate vertex buffer ID
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID)); // Assign buffer type Array
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-}
+    // Stream mode only: direct access to the ring (alignment is usually the vertex stride)
+    void *Map(uint size, uint alignment);
+    void Unmap();
+    inline uint GetStreamOffset() const { return m_Stream ? m_Stream->GetMappedOffset() : 0; }
+    inline const StreamingBuffer *GetStream() const { return m_Stream.get(); }
+};
@@ -5,21 +5,21 @@
 // ============================================================================
 
 template <>
-void VertexBufferLayout::Push<float>(unsigned int count)
+void VertexBufferLayout::Push<float>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({GL_FLOAT, count, GL_FALSE});
+    m_Elements.push_back({GL_FLOAT, count, GL_FALSE, divisor});
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
 }
 
 template <>
-void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+void VertexBufferLayout::Push<unsigned int>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE});
+    m_Elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE, divisor});
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
 }
 template <>
-void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+void VertexBufferLayout::Push<unsigned char>(unsigned int count, unsigned int divisor)
 {
-    m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE});
+    m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE, divisor});
     m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
 }
\ No newline at end of file
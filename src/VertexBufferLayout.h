@@ -12,6 +12,7 @@ struct VertexBufferElement
     uint type;
     uint count;
     unsigned char normalized;
+    uint divisor; // 0 = per vertex, n = advance once every n instances
     static uint GetSizeOfType(uint type)
     {
         switch (type)
@@ -39,7 +40,7 @@ public:
     ~VertexBufferLayout() {};
 
     template <typename T>
-    void Push(uint count); //{ static_assert(false); }
+    void Push(uint count, uint divisor = 0); //{ static_assert(false); }
     inline const std::vector<VertexBufferElement> &GetElements() const { return m_Elements; };
     inline uint GetStride() const { return m_Stride; }
 };
\ No newline at end of file
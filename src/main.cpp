@@ -33,6 +33,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <string>
 
 #include "vendor/imgui/imgui.h"
 #include "vendor/imgui/imgui_impl_glfw.h"
@@ -40,68 +45,340 @@
 
 #include "Renderer.h"
 #include "Texture.h"
+#include "AssetPack.h"
+#include "Framebuffer.h"
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "RenderPipeline.h"
+#include "FrameClock.h"
+#include "ProgramCache.h"
+#include "ShaderLibrary.h"
 
 #include "tests/Test.h"
 #include "tests/TestClearColor.h"
 #include "tests/TestSquare.h"
 #include "tests/TestTexture2D.h"
+#include "tests/TestBatchRenderer.h"
+#include "tests/TestInstancing.h"
+#include "tests/TestUniformBuffer.h"
+#include "tests/TestUniformLookup.h"
+#include "tests/TestTextureStreaming.h"
+#include "tests/TestTextureAtlas.h"
+#include "tests/TestMipmaps.h"
+#include "tests/TestCompressedTextures.h"
+#include "tests/TestAssetPack.h"
+#include "tests/TestRenderQueue.h"
+#include "tests/TestJobSystem.h"
+#include "tests/TestFixedTimestep.h"
+#include "tests/TestTransforms.h"
 
-int main(void)
+static const int s_Width = 960;
+static const int s_Height = 540;
+
+struct AppOptions
 {
-	/* Initialize the library */
-	if (!glfwInit())
-		return -1;
+	bool Headless = false;  // Hidden window, render into a Framebuffer
+	std::string TestName;   // Test to run when headless
+	int Frames = 300;       // Frames to run when headless
+	std::string OutputPath; // Optional PPM of the last headless frame
+	bool Benchmark = false; // Run the benchmark harness instead (implies headless)
+	bool ClearShaderCache = false; // Start cold, without cached program binaries
+	std::string PackPath = "res.pack"; // Mounted if it exists, built by "make pack"
+	FramePacing Pacing = FramePacing::VSync; // Interactive only, headless runs are uncapped
+	int TargetFps = 60;
+	BenchmarkOptions Bench;
+};
 
-	const char *glsl_version = "#version 130";
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+static void PrintUsage(const char *program)
+{
+	std::cout << "Usage: " << program << " [--headless --test <name> [--frames <n>] [--output <file.ppm>]]" << std::endl;
+	std::cout << "       " << program << " --benchmark [--test <name>] [--warmup <n>] [--frames <n>] [--json <file>]"
+			  << " [--csv <file>] [--baseline <file.csv>] [--threshold <percent>] [--sweeps]" << std::endl;
+	std::cout << "       --sweeps also runs each test's \"Run benchmark\" sweep and its checks" << std::endl;
+	std::cout << "       --clear-shader-cache empties .shadercache/ first, for a cold start" << std::endl;
+	std::cout << "       --pack <file> mounts another asset pack (default res.pack, if present)" << std::endl;
+	std::cout << "       --loose reads the files under res/ even when res.pack exists" << std::endl;
+	std::cout << "       --pacing vsync|uncapped|adaptive|<fps> picks the frame pacing (default vsync)" << std::endl;
+}
 
-	/* Create a window and OpenGL context */
-	GLFWwindow *window = glfwCreateWindow(960, 540, "Hello World.", NULL, NULL);
+static bool ParseOptions(int argc, char **argv, AppOptions &options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (!strcmp(argv[i], "--headless"))
+			options.Headless = true;
+		else if (!strcmp(argv[i], "--clear-shader-cache"))
+			options.ClearShaderCache = true;
+		else if (!strcmp(argv[i], "--pack") && hasValue)
+			options.PackPath = argv[++i];
+		else if (!strcmp(argv[i], "--loose"))
+			options.PackPath.clear();
+		else if (!strcmp(argv[i], "--pacing") && hasValue)
+		{
+			const char *pacing = argv[++i];
+			if (!strcmp(pacing, "vsync"))
+				options.Pacing = FramePacing::VSync;
+			else if (!strcmp(pacing, "uncapped"))
+				options.Pacing = FramePacing::Uncapped;
+			else if (!strcmp(pacing, "adaptive"))
+				options.Pacing = FramePacing::Adaptive;
+			else if (atoi(pacing) > 0)
+			{
+				options.Pacing = FramePacing::TargetFps;
+				options.TargetFps = atoi(pacing);
+			}
+			else
+				return false;
+		}
+		else if (!strcmp(argv[i], "--benchmark"))
+			options.Benchmark = options.Headless = true;
+		else if (!strcmp(argv[i], "--test") && hasValue)
+			options.TestName = options.Bench.TestName = argv[++i];
+		else if (!strcmp(argv[i], "--frames") && hasValue)
+		{
+			options.Frames = options.Bench.MeasuredFrames = atoi(argv[++i]);
+			if (options.Frames <= 0)
+				return false;
+		}
+		else if (!strcmp(argv[i], "--output") && hasValue)
+			options.OutputPath = argv[++i];
+		else if (!strcmp(argv[i], "--warmup") && hasValue)
+		{
+			options.Bench.WarmupFrames = atoi(argv[++i]);
+			if (options.Bench.WarmupFrames < 0)
+				return false;
+		}
+		else if (!strcmp(argv[i], "--json") && hasValue)
+			options.Bench.JsonPath = argv[++i];
+		else if (!strcmp(argv[i], "--csv") && hasValue)
+			options.Bench.CsvPath = argv[++i];
+		else if (!strcmp(argv[i], "--baseline") && hasValue)
+			options.Bench.BaselinePath = argv[++i];
+		else if (!strcmp(argv[i], "--threshold") && hasValue)
+			options.Bench.Threshold = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--sweeps"))
+			options.Bench.Sweeps = true;
+		else
+			return false;
+	}
+	return !options.Headless || options.Benchmark || !options.TestName.empty();
+}
+
+static void PrintShaderStats()
+{
+	const ProgramCache::Stats &stats = ProgramCache::Get().GetStats();
+	std::cout << "Shaders: " << stats.Compiled << " compiled from source in " << stats.CompileMs << " ms (cold), "
+			  << stats.Loaded << " loaded from binary in " << stats.LoadMs << " ms (warm), "
+			  << ShaderLibrary::Get().GetStats().Hits << " reused";
+	if (stats.Rejected)
+		std::cout << ", " << stats.Rejected << " binaries rejected";
+	std::cout << std::endl;
+}
+
+static void RegisterTests(test::TestMenu &testMenu)
+{
+	testMenu.RegisterTest<test::TestClearColor>("Clear Color");
+	testMenu.RegisterTest<test::TestSquare>("Square");
+	testMenu.RegisterTest<test::TestTexture2D>("2D Texture");
+	testMenu.RegisterTest<test::TestBatchRenderer>("Batch Renderer");
+	testMenu.RegisterTest<test::TestInstancing>("Instancing");
+	testMenu.RegisterTest<test::TestUniformBuffer>("Uniform Buffer");
+	testMenu.RegisterTest<test::TestUniformLookup>("Uniform Lookup");
+	testMenu.RegisterTest<test::TestTextureStreaming>("Texture Streaming");
+	testMenu.RegisterTest<test::TestTextureAtlas>("Texture Atlas");
+	testMenu.RegisterTest<test::TestMipmaps>("Texture Minification");
+	testMenu.RegisterTest<test::TestCompressedTextures>("Compressed Textures");
+	testMenu.RegisterTest<test::TestAssetPack>("Asset Pack");
+	testMenu.RegisterTest<test::TestRenderQueue>("Render Queue");
+	testMenu.RegisterTest<test::TestJobSystem>("Job System");
+	testMenu.RegisterTest<test::TestFixedTimestep>("Fixed Timestep");
+	testMenu.RegisterTest<test::TestTransforms>("Transforms");
+}
+
+/*
+ * Headless contexts: a hidden window is enough when there is a display.
+ * Without one (build servers) GLFW 3.4's null platform is used, with an
+ * EGL (surfaceless) context and OSMesa as fallback, e.g. on Mesa llvmpipe.
+ */
+static GLFWwindow *CreateAppWindow(const AppOptions &options)
+{
+	if (!options.Headless)
+		return glfwCreateWindow(s_Width, s_Height, "Hello World.", NULL, NULL);
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *window = glfwCreateWindow(s_Width, s_Height, "Headless", NULL, NULL);
 	if (!window)
 	{
-		glfwTerminate();
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		window = glfwCreateWindow(s_Width, s_Height, "Headless", NULL, NULL);
+	}
+	if (!window)
+	{
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+		window = glfwCreateWindow(s_Width, s_Height, "Headless", NULL, NULL);
+	}
+	return window;
+}
+
+static int RunHeadless(const AppOptions &options)
+{
+	test::Test *currentTest = nullptr;
+	test::TestMenu testMenu(currentTest);
+	RegisterTests(testMenu);
+
+	currentTest = testMenu.CreateTest(options.TestName);
+	if (!currentTest)
+	{
+		std::cout << "Unknown test '" << options.TestName << "', available tests:" << std::endl;
+		for (auto &test : testMenu.GetTests())
+			std::cout << "  " << test.first << std::endl;
 		return -1;
 	}
 
-	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1); // Enable vsync
+	{
+		Renderer renderer;
+		Framebuffer framebuffer(s_Width, s_Height);
+		framebuffer.Bind();
 
-	if (glewInit() != GLEW_OK)
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < options.Frames; ++frame)
+		{
+			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+			renderer.Clear();
+			/* One fixed step per frame, so the output does not depend on how fast we run */
+			FrameClock &clock = FrameClock::Get();
+			clock.TickFixed();
+			currentTest->OnUpdate(clock.GetDelta());
+			while (clock.Step())
+				currentTest->OnFixedUpdate(clock.GetFixedStep());
+			currentTest->OnRender();
+		}
+		GLCall(glFinish()); // Nothing is presented, so wait for the GPU explicitly
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "Ran '" << options.TestName << "' for " << options.Frames << " frames: "
+				  << elapsed / options.Frames << " ms/frame (" << options.Frames * 1000.0 / elapsed << " FPS)" << std::endl;
+		if (!options.OutputPath.empty() && !framebuffer.SaveColorAttachment(options.OutputPath))
+			std::cout << "Failed to write " << options.OutputPath << std::endl;
+	}
+
+	delete currentTest;
+	return 0;
+}
+
+static int RunBenchmark(const AppOptions &options)
+{
+	test::Test *currentTest = nullptr;
+	test::TestMenu testMenu(currentTest);
+	RegisterTests(testMenu);
+
+	BenchmarkRunner runner(options.Bench);
+	std::vector<BenchmarkResult> results = runner.Run(testMenu);
+	if (results.empty())
 	{
-		glfwTerminate();
+		std::cout << "No test named '" << options.Bench.TestName << "'" << std::endl;
 		return -1;
 	}
 
-	std::cout << glGetString(GL_VERSION) << std::endl;
+	if (!options.Bench.JsonPath.empty() && !BenchmarkRunner::WriteJson(options.Bench.JsonPath, results))
+		std::cout << "Failed to write " << options.Bench.JsonPath << std::endl;
+	if (!options.Bench.CsvPath.empty() && !BenchmarkRunner::WriteCsv(options.Bench.CsvPath, results))
+		std::cout << "Failed to write " << options.Bench.CsvPath << std::endl;
+
+	bool passed = true;
+	for (const BenchmarkResult &result : results)
+		if (!result.Passed)
+		{
+			std::cout << result.Name << ": sweep checks failed" << std::endl;
+			passed = false;
+		}
 
+	if (!options.Bench.BaselinePath.empty())
 	{
-		Renderer renderer;
+		std::map<std::string, BenchmarkResult> baseline;
+		if (!BenchmarkRunner::ReadCsv(options.Bench.BaselinePath, baseline))
+		{
+			std::cout << "Failed to read baseline " << options.Bench.BaselinePath << std::endl;
+			return -1;
+		}
+		if (!runner.CompareToBaseline(results, baseline))
+			return 1; // Regression
+	}
+	return passed ? 0 : 1;
+}
+
+static int RunInteractive(GLFWwindow *window)
+{
+	const char *glsl_version = "#version 130";
+	Renderer renderer;
+
+	/* Setup Dear ImGui context */
+	IMGUI_CHECKVERSION();
+	ImGui::CreateContext();
+	ImGui::StyleColorsDark();
 
-		/* Setup Dear ImGui context */
-		IMGUI_CHECKVERSION();
-		ImGui::CreateContext();
-		ImGui::StyleColorsDark();
+	/* Setup Platform/Renderer backends */
+	ImGui_ImplGlfw_InitForOpenGL(window, true);
+	ImGui_ImplOpenGL3_Init(glsl_version);
 
-		/* Setup Platform/Renderer backends */
-		ImGui_ImplGlfw_InitForOpenGL(window, true);
-		ImGui_ImplOpenGL3_Init(glsl_version);
+	/* Off until enabled in its window, its timer queries around every draw skew the tests' numbers */
+	Profiler::Get().SetEnabled(false);
 
+	{
 		test::Test* currentTest = nullptr;
 		test::TestMenu* testMenu = new test::TestMenu(currentTest);
 		currentTest = testMenu;
+		RegisterTests(*testMenu);
 
-		testMenu->RegisterTest<test::TestClearColor>("Clear Color");
-		testMenu->RegisterTest<test::TestSquare>("Square");
-		testMenu->RegisterTest<test::TestTexture2D>("2D Texture");
+		/* Compile every shader in the background while the menu is up */
+		ShaderLibrary::Get().PreloadDirectory("res/shaders");
+		ShaderLibrary::Get().Preload({{"res/shaders/Basic.shader", {"TEXTURED"}},
+									  {"res/shaders/Basic.shader", {"TEXTURED", "INSTANCED"}}});
+		ShaderLibrary::Get().SetHotReload(true);
+
+		/* Optional render thread, only for tests that split their frame (see Test::IsPipelined) */
+		RenderPipeline pipeline(window);
+		bool pipelining = false;
+		FrameClock &clock = FrameClock::Get();
+		auto renderFrame = [&](uint slot) {
+			clock.ApplySwapInterval();
+			ShaderLibrary::Get().Update();
+			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+			renderer.Clear();
+			currentTest->OnRenderSnapshot(slot);
+			ImGui_ImplOpenGL3_RenderDrawData(pipeline.GetDrawData(slot));
+			GLStateCache::Get().Invalidate(); // ImGui binds GL objects behind the cache's back
+		};
 
 		/* Loop until the user closes the window */
 		while (!glfwWindowShouldClose(window))
 		{
-			/* Render here */
-			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
-			renderer.Clear();
+			clock.Tick();
+			bool pipelined = pipelining && currentTest && currentTest->IsPipelined();
+			if (pipelined && !pipeline.IsRunning())
+				pipeline.Start(renderFrame);
+			else if (!pipelined && pipeline.IsRunning())
+				pipeline.Stop();
+
+			/* Keep last frame's state change counters for display */
+			GLStateCache::Stats stateStats;
+			uint slot = 0;
+			if (pipeline.IsRunning())
+				slot = pipeline.BeginFrame(); // The profiler and everything else GL stays off the main thread
+			else
+			{
+				stateStats = GLStateCache::Get().GetStats();
+				GLStateCache::Get().ResetStats();
+
+				Profiler::Get().BeginFrame();
+				Profiler::Get().BeginScope("Frame");
+				ShaderLibrary::Get().Update();
+
+				/* Render here */
+				GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+				renderer.Clear();
+			}
 
 			/* Start the Dear ImGui frame */
 			ImGui_ImplOpenGL3_NewFrame();
@@ -110,29 +387,92 @@ int main(void)
 
 			if (currentTest)
 			{
-				currentTest->OnUpdate(0.0f);
-				currentTest->OnRender();
+				{
+					PROFILE_SCOPE("OnUpdate");
+					currentTest->OnUpdate(clock.GetDelta());
+					while (clock.Step())
+						currentTest->OnFixedUpdate(clock.GetFixedStep());
+				}
+				if (pipeline.IsRunning())
+					currentTest->OnSnapshot(slot);
+				else
+				{
+					PROFILE_SCOPE("OnRender");
+					currentTest->OnRender();
+				}
 				ImGui::Begin("Test");
 				if (currentTest != testMenu && ImGui::Button("<-"))
 				{
+					/* The render thread may still be drawing the test, and this frame goes out serially */
+					if (pipeline.IsRunning())
+					{
+						pipeline.Stop();
+						renderer.Clear();
+					}
 					delete currentTest;
 					currentTest = testMenu;
 				}
 				currentTest->OnImGuiRender();
 				ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+				ImGui::Checkbox("Pipelined rendering", &pipelining);
+				if (pipeline.IsRunning())
+				{
+					RenderPipeline::Stats pipelineStats = pipeline.GetStats();
+					ImGui::Text("Simulate %.2f ms, render %.2f ms, waiting for a slot %.2f ms, latency %.2f ms",
+								pipelineStats.SimulateMs, pipelineStats.RenderMs, pipelineStats.WaitMs, pipelineStats.LatencyMs);
+				}
+				else
+				{
+					if (pipelining)
+						ImGui::Text("This test renders serially");
+					/* Owned by the render thread while the pipeline runs */
+					ImGui::Text("GL state calls: %u issued, %u skipped", stateStats.Issued, stateStats.Skipped);
+					const ProgramCache::Stats &shaderStats = ProgramCache::Get().GetStats();
+					const ShaderLibrary::Stats &libraryStats = ShaderLibrary::Get().GetStats();
+					ImGui::Text("Shaders: %u compiled (%.1f ms), %u from binary (%.1f ms), %u reused, %u compiling",
+								shaderStats.Compiled, shaderStats.CompileMs, shaderStats.Loaded, shaderStats.LoadMs,
+								libraryStats.Hits, libraryStats.Pending);
+					bool hotReload = ShaderLibrary::Get().IsHotReloadEnabled();
+					if (ImGui::Checkbox("Hot reload shaders", &hotReload))
+						ShaderLibrary::Get().SetHotReload(hotReload);
+					ImGui::SameLine();
+					ImGui::Text("%u reloaded, %u failed", libraryStats.Reloads, libraryStats.ReloadFailures);
+				}
 				ImGui::End();
 			}
+			Profiler::Get().OnImGuiRender();
+			clock.OnImGuiRender();
 			
 			ImGui::Render();
 
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			if (pipeline.IsRunning())
+			{
+				/* The render thread draws and presents it */
+				pipeline.CaptureImGui(slot);
+				clock.WaitForTarget();
+				pipeline.SubmitFrame(slot);
+			}
+			else
+			{
+				{
+					PROFILE_SCOPE("ImGui");
+					ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+				}
+				GLStateCache::Get().Invalidate(); // ImGui binds GL objects behind the cache's back
+
+				Profiler::Get().EndScope();
+				Profiler::Get().EndFrame();
 
-			/* Swap front and back buffers */
-			glfwSwapBuffers(window);
+				/* Swap front and back buffers */
+				clock.WaitForTarget();
+				clock.ApplySwapInterval();
+				glfwSwapBuffers(window);
+			}
 
 			/* Poll for and process events */
 			glfwPollEvents();
 		}
+		pipeline.Stop();
 
 		/* Cleanup */
 		delete currentTest;
@@ -142,11 +482,90 @@ int main(void)
 	}
 
 	/* Cleanup */
+	Profiler::Get().Shutdown();
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	AppOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return -1;
+	}
+
+#ifdef GLFW_PLATFORM_NULL
+	if (options.Headless && !getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY"))
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+
+	/* Initialize the library */
+	if (!glfwInit())
+		return -1;
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifndef NDEBUG
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+	/* Create a window and OpenGL context */
+	GLFWwindow *window = CreateAppWindow(options);
+	if (!window)
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	glfwMakeContextCurrent(window);
+	/* Vsync (or the chosen pacing), unless we measure throughput */
+	FrameClock::Get().SetPacing(options.Headless ? FramePacing::Uncapped : options.Pacing);
+	FrameClock::Get().SetTargetFps(options.TargetFps);
+	FrameClock::Get().ApplySwapInterval();
+
+	/* GLEW built for GLX complains without an X display, but core entry points are loaded */
+	GLenum glewStatus = glewInit();
+	if (glewStatus != GLEW_OK && !(options.Headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY))
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	std::cout << glGetString(GL_VERSION) << std::endl;
+#ifndef NDEBUG
+	/* Synchronous, so GLCall stops at the call that failed */
+	if (!GLInitDebugOutput(true))
+		std::cout << "KHR_debug not available, checking glGetError after every GL call" << std::endl;
+#endif
+
+	if (options.ClearShaderCache)
+		ProgramCache::Get().Clear();
+
+	/* Assets come from the pack when there is one, loose files otherwise */
+	std::unique_ptr<AssetPack> pack;
+	if (!options.PackPath.empty())
+	{
+		pack = std::make_unique<AssetPack>(options.PackPath);
+		if (pack->IsValid())
+		{
+			AssetPack::Mount(pack.get());
+			std::cout << "Mounted " << options.PackPath << " (" << pack->GetAssetCount() << " assets)" << std::endl;
+		}
+	}
+
+	int result = options.Benchmark  ? RunBenchmark(options)
+				 : options.Headless ? RunHeadless(options)
+									: RunInteractive(window);
+	PrintShaderStats();
+	ShaderLibrary::Get().Clear(); // Programs must go before the context does
+	AssetPack::Mount(nullptr);
 
 	glfwDestroyWindow(window);
 	glfwTerminate();
-	return 0;
-}
\ No newline at end of file
+	return result;
+}
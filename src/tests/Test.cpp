@@ -0,0 +1,24 @@
+#include "Test.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    void TestMenu::OnImGuiRender()
+    {
+        for (auto &test : m_Tests)
+            if (ImGui::Button(test.first.c_str()))
+                m_CurrentTest = test.second();
+    }
+
+    Test *TestMenu::CreateTest(const std::string &testName) const
+    {
+        for (auto &test : m_Tests)
+            if (test.first == testName)
+                return test.second();
+        return nullptr;
+    }
+}
@@ -1,9 +1,13 @@
 #pragma once
 #include <functional>
+#include <string>
 #include <vector>
 
+#include "../Util.h"
 #include "../vendor/imgui/imgui.h"
 
+class BenchmarkSweep;
+
 namespace test
 {
 
@@ -16,9 +20,27 @@ namespace test
     public:
         Test() {}
         virtual ~Test() {}
+        // Once a frame, deltaTime in seconds since the previous frame
         virtual void OnUpdate(float deltaTime) {}
+        // Zero or more times a frame at a fixed rate (see FrameClock), render
+        // in between states with FrameClock::Get().GetInterpolation()
+        virtual void OnFixedUpdate(float step) {}
         virtual void OnRender() {}
         virtual void OnImGuiRender() {}
+
+        /*
+         * Pipelined rendering (see RenderPipeline): OnSnapshot() runs on the
+         * main thread after OnUpdate() and keeps what the frame needs in one
+         * of RenderPipeline::SlotCount slots, without touching GL.
+         * OnRenderSnapshot() draws a slot on the render thread, while the
+         * main thread fills the next one. Other tests always run serially.
+         */
+        virtual bool IsPipelined() const { return false; }
+        virtual void OnSnapshot(uint slot) {}
+        virtual void OnRenderSnapshot(uint slot) {}
+
+        // Tests that compare configurations return their sweep, so it can also run headless
+        virtual BenchmarkSweep *GetBenchmarkSweep() { return nullptr; }
     };
 
     class TestMenu : public Test
@@ -30,6 +52,10 @@ namespace test
         template <typename T>
         void RegisterTest(const std::string& testName);
         void OnImGuiRender() override;
+
+        // Returns a new instance of the named test, or nullptr if it isn't registered
+        Test *CreateTest(const std::string &testName) const;
+        inline const std::vector<std::pair<std::string, std::function<Test *()>>> &GetTests() const { return m_Tests; }
     private:
         Test *&m_CurrentTest;
         std::vector<std::pair<std::string, std::function<Test *()>>> m_Tests;
@@ -44,11 +70,4 @@ namespace test
     {
         m_Tests.push_back(std::make_pair(testName, [](){ return new T(); }));
     }
-
-    void TestMenu::OnImGuiRender()
-    {
-        for (auto &test : m_Tests)
-            if (ImGui::Button(test.first.c_str()))
-                m_CurrentTest = test.second();
-    }
-}
\ No newline at end of file
+}
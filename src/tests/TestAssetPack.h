@@ -0,0 +1,46 @@
+#pragma once
+#include "Test.h"
+
+#include <string>
+#include <vector>
+
+#include "../Util.h"
+#include "../AssetPack.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Loads every asset of the mounted pack twice: from the loose files
+     * under res/ (open + read into a heap buffer each) and through views
+     * into the pack, and does the same for the textures. Nothing is drawn.
+     */
+    class TestAssetPack : public Test
+    {
+    public:
+        TestAssetPack();
+        ~TestAssetPack() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        struct Result
+        {
+            double ReadMs = 0.0;    // Every byte touched once
+            double TextureMs = 0.0; // Texture objects, decode and upload
+            size_t PeakBytes = 0;   // Largest heap copy alive at once
+        };
+
+        void Measure();
+
+        std::vector<std::string> m_Paths;
+        Result m_Loose, m_Packed;
+        size_t m_TotalBytes = 0;
+        bool m_Match = false;
+    };
+}
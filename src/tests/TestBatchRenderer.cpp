@@ -0,0 +1,68 @@
+#include "TestBatchRenderer.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestBatchRenderer::TestBatchRenderer() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                             m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0)))
+    {
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_BatchRenderer = std::make_unique<BatchRenderer>();
+        m_Texture = std::make_unique<Texture>("res/textures/icon.png");
+    }
+    void TestBatchRenderer::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        /* Lay the quads out on a grid that fills the window */
+        int columns = (int)std::ceil(std::sqrt(m_QuadCount * 960.0f / 540.0f));
+        int rows = (m_QuadCount + columns - 1) / columns;
+        glm::vec2 cell(960.0f / columns, 540.0f / rows);
+        glm::vec2 size = cell * 0.8f;
+
+        m_BatchRenderer->ResetStats();
+        m_BatchRenderer->BeginBatch(m_Proj * m_View);
+        for (int i = 0; i < m_QuadCount; ++i)
+        {
+            int x = i % columns, y = i / columns;
+            glm::vec2 position(x * cell.x, y * cell.y);
+            glm::vec4 color((float)x / columns, (float)y / rows, 1.0f, 1.0f);
+            if (m_Rotation != 0.0f)
+            {
+                glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position + size * 0.5f, 0.0f));
+                transform = glm::rotate(transform, glm::radians(m_Rotation), glm::vec3(0, 0, 1));
+                transform = glm::translate(transform, glm::vec3(size * -0.5f, 0.0f));
+                transform = glm::scale(transform, glm::vec3(size, 1.0f));
+                if (m_Textured && (x + y) % 2)
+                    m_BatchRenderer->SubmitQuad(transform, *m_Texture, color);
+                else
+                    m_BatchRenderer->SubmitQuad(transform, color);
+            }
+            else if (m_Textured && (x + y) % 2)
+                m_BatchRenderer->SubmitQuad(position, size, *m_Texture, color);
+            else
+                m_BatchRenderer->SubmitQuad(position, size, color);
+        }
+        m_BatchRenderer->EndBatch();
+    }
+    void TestBatchRenderer::OnImGuiRender()
+    {
+        ImGui::SliderInt("Quads", &m_QuadCount, 1, 100000);
+        ImGui::SliderFloat("Rotation", &m_Rotation, 0.0f, 360.0f);
+        ImGui::Checkbox("Textured", &m_Textured);
+
+        const BatchRenderer::Stats &stats = m_BatchRenderer->GetStats();
+        ImGui::Text("Draws per frame: %u", stats.DrawCount);
+        ImGui::Text("Quads per frame: %u", stats.QuadCount);
+        ImGui::Text("Streaming buffer fence waits: %.3f ms total", m_BatchRenderer->GetFenceWaitMs());
+    }
+}
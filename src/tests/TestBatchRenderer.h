@@ -0,0 +1,39 @@
+#pragma once
+#include "Test.h"
+
+#include <cmath>
+#include <memory>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../BatchRenderer.h"
+#include "../Texture.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    class TestBatchRenderer : public Test
+    {
+    public:
+        TestBatchRenderer();
+        ~TestBatchRenderer() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        std::unique_ptr<BatchRenderer> m_BatchRenderer;
+        std::unique_ptr<Texture> m_Texture;
+
+        glm::mat4 m_Proj;
+        glm::mat4 m_View;
+        int m_QuadCount = 100000;
+        bool m_Textured = true;
+        float m_Rotation = 0.0f;
+    };
+}
@@ -22,18 +22,4 @@ namespace test
     private:
         float m_ClearColor[4];
     };
-
-    // ============================================================================
-    // Implementation
-    // ============================================================================
-
-    void TestClearColor::OnRender()
-    {
-        GLCall(glClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]));
-        GLCall(glClear(GL_COLOR_BUFFER_BIT));
-    }
-    void TestClearColor::OnImGuiRender()
-    {
-        ImGui::ColorEdit4("Clear Color", m_ClearColor);
-    }
-}
\ No newline at end of file
+}
@@ -0,0 +1,83 @@
+#include "TestCompressedTextures.h"
+
+#include <chrono>
+
+#include "../MappedFile.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestCompressedTextures::TestCompressedTextures() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+    {
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_BatchRenderer = std::make_unique<BatchRenderer>();
+        m_Png = std::make_unique<Texture>(s_PngPath);
+        for (int level = 0; level < m_Png->GetLevelCount(); ++level)
+            m_PngBytes += (size_t)Mipmap::GetLevelSize(m_Png->GetWidth(), level) *
+                          Mipmap::GetLevelSize(m_Png->GetHeight(), level) * 4;
+
+        /* Sizes straight from the container, the driver stores the blocks as they are */
+        MappedFile file(s_KtxPath);
+        KtxFile ktx;
+        std::string error;
+        m_KtxFound = file.IsValid() && ktx.Parse(file.GetData(), file.GetSize(), error);
+        if (m_KtxFound)
+        {
+            m_Ktx = std::make_unique<Texture>(s_KtxPath);
+            m_KtxFormat = ktx.GetInternalFormat();
+            for (const KtxFile::Level &level : ktx.GetLevels())
+                m_KtxBytes += level.Size;
+        }
+        MeasureLoads();
+    }
+    void TestCompressedTextures::MeasureLoads()
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < s_LoadCount; ++i)
+            Texture texture(s_PngPath);
+        GLCall(glFinish());
+        auto png = std::chrono::steady_clock::now();
+        if (m_KtxFound)
+            for (int i = 0; i < s_LoadCount; ++i)
+                Texture texture(s_KtxPath);
+        GLCall(glFinish());
+        auto ktx = std::chrono::steady_clock::now();
+
+        m_PngLoadMs = std::chrono::duration<double, std::milli>(png - start).count() / s_LoadCount;
+        m_KtxLoadMs = std::chrono::duration<double, std::milli>(ktx - png).count() / s_LoadCount;
+    }
+    void TestCompressedTextures::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        m_BatchRenderer->BeginBatch(m_Proj);
+        m_BatchRenderer->SubmitQuad(glm::vec2(130.0f, 120.0f), glm::vec2(300.0f), *m_Png);
+        if (m_Ktx)
+            m_BatchRenderer->SubmitQuad(glm::vec2(530.0f, 120.0f), glm::vec2(300.0f), *m_Ktx);
+        m_BatchRenderer->EndBatch();
+    }
+    void TestCompressedTextures::OnImGuiRender()
+    {
+        ImGui::Text("Left: %s, right: %s", s_PngPath, s_KtxPath);
+        if (!m_KtxFound)
+        {
+            ImGui::Text("%s not found, run \"make textures\"", s_KtxPath);
+            return;
+        }
+        ImGui::Text("KTX format 0x%04x, supported: %s", m_KtxFormat,
+                    Texture::IsFormatSupported(m_KtxFormat) ? "yes" : "no");
+        ImGui::Text("Video memory: PNG %zu bytes (RGBA8 + mips), KTX %zu bytes", m_PngBytes, m_KtxBytes);
+        ImGui::Text("Load: PNG %.3f ms, KTX %.3f ms (mean of %d)", m_PngLoadMs, m_KtxLoadMs, s_LoadCount);
+        if (ImGui::Button("Measure again"))
+            MeasureLoads();
+    }
+}
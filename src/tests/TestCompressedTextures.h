@@ -0,0 +1,50 @@
+#pragma once
+#include "Test.h"
+
+#include <memory>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../BatchRenderer.h"
+#include "../Texture.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Shows res/textures/icon.png next to the icon.ktx baked by
+     * "make textures", and compares load time (decode + upload against map
+     * + upload) and the video memory each one takes.
+     */
+    class TestCompressedTextures : public Test
+    {
+    public:
+        TestCompressedTextures();
+        ~TestCompressedTextures() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        static constexpr const char *s_PngPath = "res/textures/icon.png";
+        static constexpr const char *s_KtxPath = "res/textures/icon.ktx";
+        static constexpr int s_LoadCount = 100;
+
+        void MeasureLoads();
+
+        std::unique_ptr<BatchRenderer> m_BatchRenderer;
+        std::unique_ptr<Texture> m_Png;
+        std::unique_ptr<Texture> m_Ktx;
+
+        glm::mat4 m_Proj;
+        bool m_KtxFound = false;
+        size_t m_PngBytes = 0, m_KtxBytes = 0;
+        uint m_KtxFormat = 0;
+        double m_PngLoadMs = 0.0, m_KtxLoadMs = 0.0;
+    };
+}
@@ -0,0 +1,98 @@
+#include "TestFixedTimestep.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestFixedTimestep::TestFixedTimestep() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+    {
+        float positions[] = {-0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f,
+                             0.5f, 0.5f, 1.0f, 1.0f, -0.5f, 0.5f, 0.0f, 1.0f};
+        uint indices[] = {0, 1, 2, 2, 3, 0};
+
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader");
+        m_ModelHandle = m_Shader->GetUniformHandle("u_Model");
+        m_ColorHandle = m_Shader->GetUniformHandle("u_Color");
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+
+        /* Start at different heights and speeds so the balls never line up */
+        for (int i = 0; i < s_BallCount; ++i)
+        {
+            glm::vec2 position(40.0f + i * 75.0f, 300.0f + 15.0f * i);
+            m_Balls.push_back({position, position, glm::vec2(60.0f + 20.0f * i, 0.0f)});
+        }
+        FrameClock::Get().SetFixedStep(1.0 / m_StepRate);
+    }
+    TestFixedTimestep::~TestFixedTimestep()
+    {
+        FrameClock::Get().SetFixedStep(FrameClock::DefaultFixedStep);
+    }
+    void TestFixedTimestep::OnFixedUpdate(float step)
+    {
+        const float gravity = -900.0f;
+        for (Ball &ball : m_Balls)
+        {
+            ball.Previous = ball.Current;
+            ball.Velocity.y += gravity * step;
+            ball.Current = ball.Current + ball.Velocity * step;
+
+            /* Each ball bounces in its half of the window, above or below the middle */
+            if (ball.Current.y < 280.0f)
+            {
+                ball.Current.y = 280.0f;
+                ball.Velocity.y = 640.0f;
+            }
+            if (ball.Current.x < 0.0f || ball.Current.x > 960.0f)
+            {
+                ball.Current.x = ball.Current.x < 0.0f ? 0.0f : 960.0f;
+                ball.Velocity.x = -ball.Velocity.x;
+            }
+        }
+        m_Steps++;
+    }
+    void TestFixedTimestep::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        CameraBlock camera{m_Proj};
+        m_Camera->SetData(&camera, sizeof(camera));
+        m_Camera->BindBase(CameraBinding);
+
+        float alpha = FrameClock::Get().GetInterpolation();
+        m_Shader->Bind();
+        for (const Ball &ball : m_Balls)
+        {
+            /* Top: interpolated. Bottom: the same ball at its latest fixed state, shifted down */
+            glm::vec2 interpolated = ball.Previous + (ball.Current - ball.Previous) * alpha;
+            glm::vec2 positions[2] = {interpolated, ball.Current - glm::vec2(0.0f, 270.0f)};
+            for (int row = 0; row < 2; ++row)
+            {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(positions[row], 0.0f));
+                model = glm::scale(model, glm::vec3(24.0f));
+                m_Shader->SetUniformMat4f(m_ModelHandle, model);
+                m_Shader->SetUniform4f(m_ColorHandle, row ? 1.0f : 0.3f, row ? 0.4f : 0.8f, 0.3f, 1.0f);
+                renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+            }
+        }
+    }
+    void TestFixedTimestep::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Step rate (Hz)", &m_StepRate, 5, 240))
+            FrameClock::Get().SetFixedStep(1.0 / m_StepRate);
+        ImGui::Text("Top: interpolated (%.2f), bottom: latest step", FrameClock::Get().GetInterpolation());
+        ImGui::Text("%u fixed steps, frame delta %.2f ms", m_Steps, FrameClock::Get().GetDelta() * 1000.0f);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Test.h"
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Renderer.h"
+#include "../FrameClock.h"
+#include "../UniformBuffer.h"
+#include "../ShaderLibrary.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Bouncing balls simulated in OnFixedUpdate(). The top row is drawn
+     * between the last two fixed states, the bottom row at the latest one,
+     * which stutters whenever the step rate and the frame rate differ (try
+     * a 20 Hz step, or a target FPS that is no multiple of it).
+     */
+    class TestFixedTimestep : public Test
+    {
+    public:
+        TestFixedTimestep();
+        ~TestFixedTimestep();
+        void OnFixedUpdate(float step) override;
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        static constexpr int s_BallCount = 12;
+
+        struct Ball
+        {
+            glm::vec2 Previous, Current; // Fixed step states, Current is the newest
+            glm::vec2 Velocity;
+        };
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::shared_ptr<Shader> m_Shader;
+        UniformHandle m_ModelHandle, m_ColorHandle;
+        std::unique_ptr<UniformBuffer> m_Camera;
+        std::vector<Ball> m_Balls;
+
+        glm::mat4 m_Proj;
+        int m_StepRate = 60; // Hz
+        uint m_Steps = 0;
+    };
+}
@@ -0,0 +1,123 @@
+#include "TestInstancing.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestInstancing::TestInstancing() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                       m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0))),
+                                       m_Sweep({"Per draw 1k", "Per draw 10k", "Per draw 100k", "Instanced 1k",
+                                                "Instanced 10k", "Instanced 100k"},
+                                               {"Submit (ms)", "Frame (ms)"})
+    {
+        float positions[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f, // 0
+            0.5f, -0.5f, 1.0f, 0.0f,  // 1
+            0.5f, 0.5f, 1.0f, 1.0f,   // 2
+            -0.5f, 0.5f, 0.0f, 1.0f   // 3
+        };
+        uint indices[] = {0, 1, 2, 2, 3, 0};
+
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED"});
+        m_Shader->Bind();
+        m_Shader->SetUniform1i("u_Texture", 0);
+        m_ModelHandle = m_Shader->GetUniformHandle("u_Model");
+        m_InstancedShader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED", "INSTANCED"});
+        m_InstancedShader->Bind();
+        m_InstancedShader->SetUniform1i("u_Texture", 0);
+        m_Texture = std::make_unique<Texture>("res/textures/icon.png");
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+
+        CreateInstances(s_InstanceCounts[m_CountIndex]);
+    }
+    void TestInstancing::CreateInstances(int count)
+    {
+        /* Lay the squares out on a grid that fills the window */
+        int columns = (int)std::ceil(std::sqrt(count * 960.0f / 540.0f));
+        int rows = (count + columns - 1) / columns;
+        glm::vec2 cell(960.0f / columns, 540.0f / rows);
+
+        m_Models.resize(count);
+        for (int i = 0; i < count; ++i)
+        {
+            glm::vec3 center((i % columns + 0.5f) * cell.x, (i / columns + 0.5f) * cell.y, 0.0f);
+            m_Models[i] = glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(cell * 0.8f, 1.0f));
+        }
+
+        /* Mesh attributes use locations 0 and 1, the model matrix continues at 2 */
+        m_VertexArray = std::make_unique<VertexArray>();
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+        m_InstanceBuffer = std::make_unique<VertexBuffer>(m_Models.data(), count * sizeof(glm::mat4));
+        VertexBufferLayout instanceLayout;
+        for (int column = 0; column < 4; ++column)
+            instanceLayout.Push<float>(4, 1); // A mat4 attribute is four vec4 columns
+        m_VertexArray->AddBuffer(*m_InstanceBuffer, instanceLayout);
+    }
+    void TestInstancing::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        /* Benchmark sweep: pick the configuration for this frame */
+        if (m_Sweep.IsStepStart())
+        {
+            m_Instanced = m_Sweep.GetStep() / 3;
+            m_CountIndex = m_Sweep.GetStep() % 3;
+            CreateInstances(s_InstanceCounts[m_CountIndex]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_Texture->Bind();
+        CameraBlock camera{m_Proj * m_View};
+        m_Camera->SetData(&camera, sizeof(camera));
+        m_Camera->BindBase(CameraBinding);
+        if (m_Instanced)
+        {
+            m_InstancedShader->Bind();
+            renderer.DrawInstanced(*m_VertexArray, *m_IndexBuffer, *m_InstancedShader, m_Models.size());
+            m_DrawCalls = 1;
+        }
+        else
+        {
+            m_Shader->Bind();
+            for (const glm::mat4 &model : m_Models)
+            {
+                m_Shader->SetUniformMat4f(m_ModelHandle, model);
+                renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+            }
+            m_DrawCalls = m_Models.size();
+        }
+        auto submitted = std::chrono::steady_clock::now();
+        GLCall(glFinish());
+        auto finished = std::chrono::steady_clock::now();
+
+        m_Last.SubmitMs = std::chrono::duration<double, std::milli>(submitted - start).count();
+        m_Last.FrameMs = std::chrono::duration<double, std::milli>(finished - start).count();
+        m_Sweep.Record({m_Last.SubmitMs, m_Last.FrameMs});
+    }
+    void TestInstancing::OnImGuiRender()
+    {
+        const char *counts[] = {"1k", "10k", "100k"};
+        if (ImGui::Combo("Instances", &m_CountIndex, counts, 3))
+            CreateInstances(s_InstanceCounts[m_CountIndex]);
+        ImGui::Checkbox("Instanced", &m_Instanced);
+        ImGui::Text("Draw calls: %u", m_DrawCalls);
+        ImGui::Text("Submit %.3f ms, frame %.3f ms", m_Last.SubmitMs, m_Last.FrameMs);
+        m_Sweep.OnImGuiRender();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Test.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Benchmark.h"
+#include "../Renderer.h"
+#include "../Texture.h"
+#include "../UniformBuffer.h"
+#include "../ShaderLibrary.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Draws the same textured square N times, either with one draw call and
+     * uniform upload per square or with a single instanced draw call.
+     * "Run benchmark" sweeps both paths over 1k/10k/100k instances.
+     */
+    class TestInstancing : public Test
+    {
+    public:
+        TestInstancing();
+        ~TestInstancing() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+        BenchmarkSweep *GetBenchmarkSweep() override { return &m_Sweep; }
+
+    private:
+        static constexpr int s_InstanceCounts[3] = {1000, 10000, 100000};
+
+        struct Result
+        {
+            double SubmitMs = 0.0; // CPU time spent issuing GL calls
+            double FrameMs = 0.0;  // Including glFinish, i.e. until the GPU is done
+        };
+
+        void CreateInstances(int count);
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::shared_ptr<Shader> m_Shader;
+        std::shared_ptr<Shader> m_InstancedShader;
+        std::unique_ptr<Texture> m_Texture;
+        UniformHandle m_ModelHandle;
+        std::unique_ptr<UniformBuffer> m_Camera;
+        std::vector<glm::mat4> m_Models;
+
+        glm::mat4 m_Proj;
+        glm::mat4 m_View;
+        int m_CountIndex = 0;
+        bool m_Instanced = true;
+        uint m_DrawCalls = 0;
+        Result m_Last;
+        BenchmarkSweep m_Sweep; // Step instanced * 3 + count index
+    };
+}
@@ -0,0 +1,181 @@
+#include "TestJobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    static std::vector<int> SweepThreadCounts()
+    {
+        int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> counts;
+        for (int threads = 1; threads < hardwareThreads; threads *= 2)
+            counts.push_back(threads);
+        counts.push_back(hardwareThreads);
+        return counts;
+    }
+
+    static std::vector<std::string> SweepSteps(const std::vector<int> &threadCounts)
+    {
+        std::vector<std::string> steps;
+        for (int threads : threadCounts)
+            steps.push_back(std::to_string(threads) + (threads == 1 ? " thread" : " threads"));
+        return steps;
+    }
+
+    TestJobSystem::TestJobSystem() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                     m_SweepThreads(SweepThreadCounts()),
+                                     m_Sweep(SweepSteps(m_SweepThreads), {"Time (ms)"})
+    {
+        float positions[] = {-0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f,
+                             0.5f, 0.5f, 1.0f, 1.0f, -0.5f, 0.5f, 0.0f, 1.0f};
+        uint indices[] = {0, 1, 2, 2, 3, 0};
+
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader");
+        m_ModelHandle = m_Shader->GetUniformHandle("u_Model");
+        m_ColorHandle = m_Shader->GetUniformHandle("u_Color");
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+
+        m_Threads = JobSystem::Get().GetThreadCount();
+        m_Sweep.SetShowSpeedup(true);
+        CreateObjects();
+    }
+    TestJobSystem::~TestJobSystem()
+    {
+        JobSystem::Get().SetThreadCount(0);
+    }
+    void TestJobSystem::CreateObjects()
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        m_Objects.resize(m_ObjectCount);
+        for (Object &object : m_Objects)
+        {
+            object.Position = glm::vec2(unit(random) * 960.0f, unit(random) * 540.0f);
+            object.Velocity = glm::vec2(unit(random) - 0.5f, unit(random) - 0.5f) * 200.0f;
+            object.Angle = unit(random) * 6.2831853f;
+            object.Spin = (unit(random) - 0.5f) * 4.0f;
+            object.Scale = 2.0f + unit(random) * 6.0f;
+            object.Color = glm::vec4(unit(random), unit(random), 1.0f, 1.0f);
+        }
+    }
+    double TestJobSystem::Simulate(Snapshot &snapshot)
+    {
+        /* Only this slot's buffers, the render thread may be replaying another one */
+        auto start = std::chrono::steady_clock::now();
+        snapshot.Buffers.resize((m_Objects.size() + s_Grain - 1) / s_Grain);
+        JobSystem::Get().ParallelFor(m_Objects.size(), s_Grain, [this, &snapshot](uint begin, uint end, uint chunk) {
+            SimulateRange(begin, end, snapshot.Buffers[chunk]);
+        });
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    void TestJobSystem::SimulateRange(uint begin, uint end, CommandBuffer &buffer)
+    {
+        const float dt = 1.0f / 60.0f; // Fixed, so every thread count does the same work
+        buffer.Clear();
+        buffer.BindShader(*m_Shader);
+        buffer.BindGeometry(*m_VertexArray, *m_IndexBuffer);
+        for (uint i = begin; i < end; ++i)
+        {
+            Object &object = m_Objects[i];
+            object.Position += object.Velocity * dt;
+            object.Angle += object.Spin * dt;
+            if (object.Position.x < 0.0f || object.Position.x > 960.0f)
+                object.Velocity.x = -object.Velocity.x;
+            if (object.Position.y < 0.0f || object.Position.y > 540.0f)
+                object.Velocity.y = -object.Velocity.y;
+
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(object.Position, 0.0f));
+            model = glm::rotate(model, object.Angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            for (int work = 0; work < m_ExtraWork; ++work)
+                model = glm::rotate(model, 0.0001f, glm::vec3(0.0f, 0.0f, 1.0f));
+            model = glm::scale(model, glm::vec3(object.Scale));
+
+            /* Cull against the window, the square fits in a circle of radius Scale */
+            glm::vec2 p = object.Position;
+            if (p.x < -object.Scale || p.x > 960.0f + object.Scale || p.y < -object.Scale ||
+                p.y > 540.0f + object.Scale)
+                continue;
+            buffer.SetUniformMat4f(m_ModelHandle, model);
+            buffer.SetUniform4f(m_ColorHandle, object.Color);
+            buffer.Draw();
+        }
+    }
+    void TestJobSystem::OnRender()
+    {
+        OnSnapshot(0);
+        OnRenderSnapshot(0);
+    }
+    void TestJobSystem::OnSnapshot(uint slot)
+    {
+        Snapshot &snapshot = m_Snapshots[slot];
+        snapshot.Draw = false;
+
+        /* Scaling benchmark: one thread count per step, nothing drawn meanwhile */
+        if (m_Sweep.IsRunning())
+        {
+            if (m_Sweep.IsStepStart())
+                JobSystem::Get().SetThreadCount(m_SweepThreads[m_Sweep.GetStep()]);
+            if (m_Sweep.Record({Simulate(snapshot)}))
+                JobSystem::Get().SetThreadCount(m_Threads);
+            return;
+        }
+
+        m_SimulateMs = Simulate(snapshot);
+        snapshot.Draw = m_Draw;
+    }
+    void TestJobSystem::OnRenderSnapshot(uint slot)
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        const Snapshot &snapshot = m_Snapshots[slot];
+        auto start = std::chrono::steady_clock::now();
+        uint draws = 0;
+        if (snapshot.Draw)
+        {
+            CameraBlock camera{m_Proj};
+            m_Camera->SetData(&camera, sizeof(camera));
+            m_Camera->BindBase(CameraBinding);
+            for (const CommandBuffer &buffer : snapshot.Buffers)
+            {
+                buffer.Execute();
+                draws += buffer.GetDrawCount();
+            }
+        }
+        m_Draws = draws;
+        m_ReplayMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    void TestJobSystem::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Objects", &m_ObjectCount, 1000, 500000))
+            CreateObjects();
+        ImGui::SliderInt("Extra work", &m_ExtraWork, 0, 64);
+        int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        if (ImGui::SliderInt("Threads", &m_Threads, 1, hardwareThreads))
+            JobSystem::Get().SetThreadCount(m_Threads);
+        ImGui::Checkbox("Draw", &m_Draw);
+
+        JobSystem::Stats stats = JobSystem::Get().GetStats();
+        ImGui::Text("Simulate + record %.3f ms, replay %.3f ms (%u draws)", m_SimulateMs, m_ReplayMs.load(),
+                    m_Draws.load());
+        ImGui::Text("%u jobs executed, %u stolen", stats.Executed, stats.Stolen);
+
+        m_Sweep.OnImGuiRender();
+    }
+}
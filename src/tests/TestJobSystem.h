@@ -0,0 +1,87 @@
+#pragma once
+#include "Test.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Benchmark.h"
+#include "../JobSystem.h"
+#include "../CommandBuffer.h"
+#include "../ShaderLibrary.h"
+#include "../RenderPipeline.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Moves, culls and records draws for many bouncing squares on every
+     * thread of the JobSystem: each chunk of objects records into its own
+     * CommandBuffer and the GL thread replays them in chunk order. "Run
+     * benchmark" times the parallel part over 1, 2, 4... threads.
+     * Supports the render pipeline: recording fills the buffers of one slot
+     * while the render thread replays another.
+     */
+    class TestJobSystem : public Test
+    {
+    public:
+        TestJobSystem();
+        ~TestJobSystem();
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+        bool IsPipelined() const override { return true; }
+        void OnSnapshot(uint slot) override;
+        void OnRenderSnapshot(uint slot) override;
+        BenchmarkSweep *GetBenchmarkSweep() override { return &m_Sweep; }
+
+    private:
+        static constexpr uint s_Grain = 1024; // Objects per job and CommandBuffer
+
+        struct Object
+        {
+            glm::vec2 Position, Velocity;
+            float Angle, Spin, Scale;
+            glm::vec4 Color;
+        };
+        struct Snapshot
+        {
+            std::vector<CommandBuffer> Buffers; // One per chunk
+            bool Draw = false;
+        };
+
+        void CreateObjects();
+        // Parallel part of a frame, returns its wall time in ms
+        double Simulate(Snapshot &snapshot);
+        void SimulateRange(uint begin, uint end, CommandBuffer &buffer);
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::shared_ptr<Shader> m_Shader;
+        UniformHandle m_ModelHandle, m_ColorHandle;
+        std::unique_ptr<UniformBuffer> m_Camera;
+        std::vector<Object> m_Objects;
+        Snapshot m_Snapshots[RenderPipeline::SlotCount];
+
+        glm::mat4 m_Proj;
+        int m_ObjectCount = 50000;
+        int m_ExtraWork = 0; // Extra matrix products per object, to make the scene heavier
+        int m_Threads;
+        bool m_Draw = true;
+        double m_SimulateMs = 0.0;
+        std::atomic<double> m_ReplayMs{0.0}; // Written by the render thread when pipelined
+        std::atomic<uint> m_Draws{0};
+
+        std::vector<int> m_SweepThreads; // Thread count of each step
+        BenchmarkSweep m_Sweep;
+    };
+}
@@ -0,0 +1,153 @@
+#include "TestMipmaps.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    static const char *s_SamplerNames[] = {"Nearest", "Bilinear", "Bilinear + mips", "Trilinear",
+                                           "Trilinear + 16x aniso"};
+
+    static std::vector<std::string> SweepSteps()
+    {
+        std::vector<std::string> steps;
+        for (const char *scene : {"Grid", "Plane"})
+            for (const char *sampler : s_SamplerNames)
+                steps.push_back(std::string(scene) + ", " + sampler);
+        return steps;
+    }
+
+    TestMipmaps::TestMipmaps() : m_Sweep(SweepSteps(), {"GPU (ms)"})
+    {
+        m_BatchRenderer = std::make_unique<BatchRenderer>();
+        m_Samplers[0] = std::make_unique<Sampler>(GL_NEAREST, GL_NEAREST);
+        m_Samplers[1] = std::make_unique<Sampler>(GL_LINEAR, GL_LINEAR);
+        m_Samplers[2] = std::make_unique<Sampler>(GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR);
+        m_Samplers[3] = std::make_unique<Sampler>(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+        m_Samplers[4] = std::make_unique<Sampler>(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, 16.0f);
+        GLCall(glGenQueries(2 * s_QueryCount, m_Queries.data()));
+
+        /* 1 pixel checkers under coarse rings: aliases badly without mips */
+        m_Pixels.resize(s_TextureSize * s_TextureSize * 4);
+        for (int y = 0; y < s_TextureSize; ++y)
+            for (int x = 0; x < s_TextureSize; ++x)
+            {
+                float dx = x - s_TextureSize * 0.5f, dy = y - s_TextureSize * 0.5f;
+                float ring = 0.5f + 0.5f * std::sin(std::sqrt(dx * dx + dy * dy) * 0.05f);
+                bool checker = (x + y) % 2;
+                unsigned char *pixel = &m_Pixels[(y * s_TextureSize + x) * 4];
+                pixel[0] = checker ? 255 : (unsigned char)(255 * ring);
+                pixel[1] = checker ? 255 : 0;
+                pixel[2] = checker ? 255 : (unsigned char)(255 * (1.0f - ring));
+                pixel[3] = 255;
+            }
+
+        /* What the offline bake costs, SIMD against the plain loop */
+        std::vector<size_t> offsets;
+        auto start = std::chrono::steady_clock::now();
+        Mipmap::GenerateChain(m_Pixels.data(), s_TextureSize, s_TextureSize, offsets);
+        auto simd = std::chrono::steady_clock::now();
+        std::vector<unsigned char> level(s_TextureSize * s_TextureSize); // In place, reads run ahead of writes
+        for (int size = s_TextureSize, source = -1; size > 1; size /= 2, ++source)
+            Mipmap::DownsampleScalar(source < 0 ? m_Pixels.data() : level.data(), size, size, level.data());
+        auto scalar = std::chrono::steady_clock::now();
+        m_CpuChainMs = std::chrono::duration<double, std::milli>(simd - start).count();
+        m_ScalarChainMs = std::chrono::duration<double, std::milli>(scalar - simd).count();
+
+        CreateTexture();
+    }
+    TestMipmaps::~TestMipmaps()
+    {
+        GLCall(glDeleteQueries(2 * s_QueryCount, m_Queries.data()));
+        Sampler::Unbind(1);
+    }
+    void TestMipmaps::CreateTexture()
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_Texture = std::make_unique<Texture>(s_TextureSize, s_TextureSize, m_Pixels.data(), (MipmapMode)m_MipmapMode);
+        GLCall(glFinish());
+        m_UploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    void TestMipmaps::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        /* Benchmark sweep: pick the configuration for this frame */
+        if (m_Sweep.IsStepStart())
+        {
+            m_Scene = m_Sweep.GetStep() / s_SamplerCount;
+            m_SamplerIndex = m_Sweep.GetStep() % s_SamplerCount;
+        }
+
+        /* Read the pair issued s_QueryCount frames ago, it is done by now in practice */
+        uint begin = m_Queries[2 * m_QueryIndex], end = m_Queries[2 * m_QueryIndex + 1];
+        if (m_QueryIssued[m_QueryIndex])
+        {
+            int available = 0;
+            GLCall(glGetQueryObjectiv(end, GL_QUERY_RESULT_AVAILABLE, &available));
+            if (available)
+            {
+                GLuint64 beginNs = 0, endNs = 0;
+                GLCall(glGetQueryObjectui64v(begin, GL_QUERY_RESULT, &beginNs));
+                GLCall(glGetQueryObjectui64v(end, GL_QUERY_RESULT, &endNs));
+                m_GpuMs = (endNs - beginNs) / 1.0e6;
+            }
+        }
+
+        /* The batch puts the first real texture on slot 1 */
+        m_Samplers[m_SamplerIndex]->Bind(1);
+        GLCall(glQueryCounter(begin, GL_TIMESTAMP));
+        if (m_Scene == 0)
+        {
+            glm::vec2 cell(960.0f / m_GridSize, 540.0f / m_GridSize);
+            m_BatchRenderer->BeginBatch(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f));
+            for (int y = 0; y < m_GridSize; ++y)
+                for (int x = 0; x < m_GridSize; ++x)
+                    m_BatchRenderer->SubmitQuad(glm::vec2(x, y) * cell, cell, *m_Texture);
+            m_BatchRenderer->EndBatch();
+        }
+        else
+        {
+            /* A floor running off to the horizon, minified far more along one axis */
+            glm::mat4 proj = glm::perspective(glm::radians(60.0f), 960.0f / 540.0f, 0.1f, 1000.0f);
+            glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.8f, -1.0f),
+                                         glm::vec3(0.0f, 1.0f, 0.0f));
+            glm::mat4 model = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1, 0, 0));
+            model = glm::scale(glm::translate(model, glm::vec3(-100.0f, 0.0f, 0.0f)), glm::vec3(200.0f, 400.0f, 1.0f));
+            m_BatchRenderer->BeginBatch(proj * view);
+            m_BatchRenderer->SubmitQuad(model, *m_Texture);
+            m_BatchRenderer->EndBatch();
+        }
+        GLCall(glQueryCounter(end, GL_TIMESTAMP));
+        m_QueryIssued[m_QueryIndex] = true;
+        m_QueryIndex = (m_QueryIndex + 1) % s_QueryCount;
+
+        /* GPU results lag a few frames, the warmup covers that */
+        m_Sweep.Record({m_GpuMs});
+    }
+    void TestMipmaps::OnImGuiRender()
+    {
+        const char *scenes[] = {"Minified grid", "Tilted plane"};
+        const char *mipmapModes[] = {"None", "GPU (glGenerateMipmap)", "CPU (box filter)"};
+        ImGui::Combo("Scene", &m_Scene, scenes, 2);
+        ImGui::Combo("Sampler", &m_SamplerIndex, s_SamplerNames, s_SamplerCount);
+        if (m_Scene == 0)
+            ImGui::SliderInt("Grid", &m_GridSize, 1, 128);
+        if (ImGui::Combo("Mipmaps", &m_MipmapMode, mipmapModes, 3))
+            CreateTexture();
+
+        ImGui::Text("GPU %.3f ms", m_GpuMs);
+        ImGui::Text("Texture creation %.1f ms, %d levels", m_UploadMs, m_Texture->GetLevelCount());
+        ImGui::Text("CPU mip chain: %.1f ms SIMD, %.1f ms scalar", m_CpuChainMs, m_ScalarChainMs);
+        ImGui::Text("Max anisotropy: %.0fx", Sampler::GetMaxAnisotropy());
+
+        m_Sweep.OnImGuiRender();
+    }
+}
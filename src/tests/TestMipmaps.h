@@ -0,0 +1,65 @@
+#pragma once
+#include "Test.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Benchmark.h"
+#include "../BatchRenderer.h"
+#include "../Sampler.h"
+#include "../Texture.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Draws a 2048x2048 high frequency texture heavily minified, either as a
+     * grid of small quads or as a plane tilted away from the camera, through
+     * one of several samplers. GPU time comes from GL_TIMESTAMP pairs (they
+     * may nest in the benchmark runner's GL_TIME_ELAPSED query) that are
+     * read back a few frames later; "Run benchmark" sweeps every
+     * sampler over both scenes.
+     */
+    class TestMipmaps : public Test
+    {
+    public:
+        TestMipmaps();
+        ~TestMipmaps();
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+        BenchmarkSweep *GetBenchmarkSweep() override { return &m_Sweep; }
+
+    private:
+        static constexpr int s_TextureSize = 2048;
+        static constexpr int s_SamplerCount = 5;
+        static constexpr int s_QueryCount = 4;
+
+        void CreateTexture();
+
+        std::unique_ptr<BatchRenderer> m_BatchRenderer;
+        std::unique_ptr<Texture> m_Texture;
+        std::vector<unsigned char> m_Pixels;
+        std::unique_ptr<Sampler> m_Samplers[s_SamplerCount];
+        std::array<uint, 2 * s_QueryCount> m_Queries; // Begin and end timestamp of each frame
+        std::array<bool, s_QueryCount> m_QueryIssued{};
+        uint m_QueryIndex = 0;
+
+        int m_SamplerIndex = 3;
+        int m_Scene = 0; // 0 grid, 1 tilted plane
+        int m_MipmapMode = 1;
+        int m_GridSize = 64;
+        double m_GpuMs = 0.0;
+        double m_UploadMs = 0.0;
+        double m_CpuChainMs = 0.0, m_ScalarChainMs = 0.0;
+        BenchmarkSweep m_Sweep; // Step scene * s_SamplerCount + sampler
+    };
+}
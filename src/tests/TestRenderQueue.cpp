@@ -0,0 +1,154 @@
+#include "TestRenderQueue.h"
+
+#include <cmath>
+#include <random>
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestRenderQueue::TestRenderQueue() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+    {
+        /* Triangle, quad and hexagon */
+        CreateMesh(m_Meshes[0], 3);
+        CreateMesh(m_Meshes[1], 4);
+        CreateMesh(m_Meshes[2], 6);
+
+        /* Checkerboards in different colors, the odd ones with transparent squares */
+        const int size = 64;
+        std::vector<unsigned char> pixels(size * size * 4);
+        for (int t = 0; t < s_TextureCount; ++t)
+        {
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                {
+                    bool odd = ((x / 8) + (y / 8)) % 2;
+                    unsigned char *pixel = &pixels[(y * size + x) * 4];
+                    pixel[0] = odd ? 255 : 60 + 30 * t;
+                    pixel[1] = odd ? 255 : 255 - 40 * t;
+                    pixel[2] = odd ? 255 : (t * 97) % 256;
+                    pixel[3] = odd && t % 2 ? 96 : 255;
+                }
+            m_Textures[t] = std::make_unique<Texture>(size, size, pixels.data(), MipmapMode::Gpu);
+        }
+
+        m_TexturedShader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED"});
+        m_ColorShader = ShaderLibrary::Get().Load("res/shaders/Basic.shader");
+        m_TexturedShader->Bind();
+        m_TexturedShader->SetUniform1i("u_Texture", 0);
+        m_TexturedModel = m_TexturedShader->GetUniformHandle("u_Model");
+        m_ColorModel = m_ColorShader->GetUniformHandle("u_Model");
+        m_Color = m_ColorShader->GetUniformHandle("u_Color");
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+
+        GLStateCache::Get().Enable(GL_DEPTH_TEST);
+        GLStateCache::Get().DepthFunc(GL_LESS);
+        CreateObjects();
+    }
+    TestRenderQueue::~TestRenderQueue()
+    {
+        GLStateCache::Get().Disable(GL_DEPTH_TEST);
+    }
+    void TestRenderQueue::CreateMesh(Mesh &mesh, int sides)
+    {
+        /* A fan around the center, unit radius, texture coordinates from the positions */
+        std::vector<float> vertices = {0.0f, 0.0f, 0.5f, 0.5f};
+        std::vector<uint> indices;
+        for (int i = 0; i < sides; ++i)
+        {
+            float angle = 2.0f * 3.14159265f * i / sides;
+            float x = std::cos(angle), y = std::sin(angle);
+            vertices.insert(vertices.end(), {x, y, 0.5f + 0.5f * x, 0.5f + 0.5f * y});
+            indices.insert(indices.end(), {0u, 1u + i, 1u + (i + 1) % sides});
+        }
+
+        mesh.Vertices = std::make_unique<VertexArray>();
+        mesh.Buffer = std::make_unique<VertexBuffer>(vertices.data(), vertices.size() * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        mesh.Vertices->AddBuffer(*mesh.Buffer, layout);
+        mesh.Indices = std::make_unique<IndexBuffer>(indices.data(), indices.size());
+    }
+    void TestRenderQueue::CreateObjects()
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        m_Objects.resize(m_ObjectCount);
+        for (Object &object : m_Objects)
+        {
+            object.Position = glm::vec2(unit(random) * 960.0f, unit(random) * 540.0f);
+            object.Scale = 6.0f + unit(random) * 18.0f;
+            object.Depth = unit(random);
+            object.Mesh = random() % s_MeshCount;
+            object.Texture = (int)(random() % (s_TextureCount + 1)) - 1;
+            object.Color = glm::vec4(unit(random), unit(random), unit(random), 1.0f);
+            object.Translucent = random() % 4 == 0;
+            if (object.Translucent)
+                object.Color.w = 0.5f;
+        }
+    }
+    void TestRenderQueue::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+        CameraBlock camera{m_Proj};
+        m_Camera->SetData(&camera, sizeof(camera));
+        m_Camera->BindBase(CameraBinding);
+
+        for (const Object &object : m_Objects)
+        {
+            const Mesh &mesh = m_Meshes[object.Mesh];
+            DrawPacket packet;
+            packet.Vertices = mesh.Vertices.get();
+            packet.Indices = mesh.Indices.get();
+            /* Far objects at z = -0.9 (the projection maps z to -z) */
+            glm::vec3 position(object.Position, -0.9f * object.Depth);
+            packet.Model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(object.Scale));
+            packet.Translucent = object.Translucent;
+            packet.Depth = object.Depth;
+            if (object.Texture >= 0)
+            {
+                packet.Program = m_TexturedShader.get();
+                packet.ModelUniform = m_TexturedModel;
+                packet.Textures[0] = m_Textures[object.Texture].get();
+                /* Transparent texels need blending too */
+                packet.Translucent |= object.Texture % 2 == 1;
+            }
+            else
+            {
+                packet.Program = m_ColorShader.get();
+                packet.ModelUniform = m_ColorModel;
+                packet.ColorUniform = m_Color;
+                packet.Color = object.Color;
+            }
+            m_Queue.Submit(packet);
+        }
+
+        uint issued = GLStateCache::Get().GetStats().Issued;
+        m_Queue.SetSorting(m_Sort);
+        m_Queue.Execute();
+        m_StateCalls = GLStateCache::Get().GetStats().Issued - issued;
+    }
+    void TestRenderQueue::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Objects", &m_ObjectCount, 100, 20000))
+            CreateObjects();
+        ImGui::Checkbox("Sort", &m_Sort);
+
+        const RenderQueue::Stats &stats = m_Queue.GetStats();
+        ImGui::Text("%u packets, sort %.3f ms, execute %.3f ms", stats.Packets, stats.SortMs, stats.ExecuteMs);
+        ImGui::Text("%-14s %10s %10s", "State changes", "Submitted", "Executed");
+        ImGui::Text("%-14s %10u %10u", "Shader", stats.Submitted.Shader, stats.Executed.Shader);
+        ImGui::Text("%-14s %10u %10u", "Material", stats.Submitted.Material, stats.Executed.Material);
+        ImGui::Text("%-14s %10u %10u", "Vertex array", stats.Submitted.VertexArray, stats.Executed.VertexArray);
+        ImGui::Text("%-14s %10u %10u", "Blend", stats.Submitted.Blend, stats.Executed.Blend);
+        int removed = stats.GetRemoved();
+        ImGui::Text("%d %s by the sort, %u GL state calls issued", removed < 0 ? -removed : removed,
+                    removed < 0 ? "added" : "removed", m_StateCalls);
+    }
+}
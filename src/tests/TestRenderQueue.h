@@ -0,0 +1,71 @@
+#pragma once
+#include "Test.h"
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../RenderQueue.h"
+#include "../ShaderLibrary.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Scatters objects over three meshes, two shader variants and six
+     * textures, a quarter of them translucent, and submits them in object
+     * order, which is as bad for state changes as it gets. The queue sorts
+     * them; turning the sort off shows what submission order costs.
+     */
+    class TestRenderQueue : public Test
+    {
+    public:
+        TestRenderQueue();
+        ~TestRenderQueue();
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        static constexpr int s_MeshCount = 3;
+        static constexpr int s_TextureCount = 6;
+
+        struct Mesh
+        {
+            std::unique_ptr<VertexArray> Vertices;
+            std::unique_ptr<VertexBuffer> Buffer;
+            std::unique_ptr<IndexBuffer> Indices;
+        };
+        struct Object
+        {
+            glm::vec2 Position;
+            float Scale, Depth;
+            int Mesh, Texture; // Texture -1 draws with the colored shader
+            glm::vec4 Color;
+            bool Translucent;
+        };
+
+        void CreateMesh(Mesh &mesh, int sides);
+        void CreateObjects();
+
+        Mesh m_Meshes[s_MeshCount];
+        std::unique_ptr<Texture> m_Textures[s_TextureCount];
+        std::shared_ptr<Shader> m_TexturedShader;
+        std::shared_ptr<Shader> m_ColorShader;
+        UniformHandle m_TexturedModel, m_ColorModel, m_Color;
+        std::unique_ptr<UniformBuffer> m_Camera;
+        RenderQueue m_Queue;
+        std::vector<Object> m_Objects;
+
+        glm::mat4 m_Proj;
+        int m_ObjectCount = 5000;
+        bool m_Sort = true;
+        uint m_StateCalls = 0; // GLStateCache calls forwarded during Execute()
+    };
+}
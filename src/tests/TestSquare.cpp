@@ -0,0 +1,69 @@
+#include "TestSquare.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestSquare::TestSquare() : positions{
+                                   -50.0f, -50.0f, 0.0f, 0.0f, // 0
+                                   50.0f, -50.0f, 1.0f, 0.0f,  // 1
+                                   50.0f, 50.0f, 1.0f, 1.0f,   // 2
+                                   -50.0f, 50.0f, 0.0f, 1.0f   // 3
+                               },
+                               indices{0, 1, 2, 2, 3, 0},                                 //
+                               vb{positions, 4 * 4 * sizeof(float)},                      //
+                               ib{indices, 6},                                            //
+                               proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), //
+                               view(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0)))
+    {
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        /* Define vertices */
+        VertexBufferLayout layout; // structure of each vertex
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        va.AddBuffer(vb, layout);
+
+        /* Bind texture */
+        shader->Bind();
+        texture.Bind();
+        shader->SetUniform1i("u_Texture", 0);
+    }
+    void TestSquare::OnRender()
+    {
+        Renderer renderer;
+        renderer.Clear();
+
+        /* Upload the camera once, every draw only sets its model matrix */
+        CameraBlock block{proj * view};
+        camera.SetData(&block, sizeof(block));
+        camera.BindBase(CameraBinding);
+
+        shader->Bind();
+
+        /* Bind and draw */
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), translationA);
+            shader->Bind();
+            shader->SetUniformMat4f("u_Model", model);
+            renderer.Draw(va, ib, *shader);
+        }
+
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), translationB);
+            shader->Bind();
+            shader->SetUniformMat4f("u_Model", model);
+            renderer.Draw(va, ib, *shader);
+        }
+    }
+    void TestSquare::OnImGuiRender()
+    {
+        ImGui::SliderFloat3("TranslationA", &translationA.x, 0.0f, 960.0f);
+        ImGui::SliderFloat3("TranslationB", &translationB.x, 0.0f, 960.0f);
+    }
+}
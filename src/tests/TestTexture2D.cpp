@@ -0,0 +1,74 @@
+#include "TestTexture2D.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestTexture2D::TestTexture2D() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                     m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0)))
+    {
+        float positions[] = {
+            -50.0f, -50.0f, 0.0f, 0.0f, // 0
+            50.0f, -50.0f, 1.0f, 0.0f,  // 1
+            50.0f, 50.0f, 1.0f, 1.0f,   // 2
+            -50.0f, 50.0f, 0.0f, 1.0f   // 3
+        };
+        uint indices[] = {0, 1, 2, 2, 3, 0}; // elements
+
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        /* Define vertices */
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+
+        /* Define elements */
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        /* Bind texture */
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED"});
+        m_Shader->Bind();
+        m_Texture = std::make_unique<Texture>("res/textures/icon.png");
+        m_Shader->SetUniform1i("u_Texture", 0);
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+    }
+    void TestTexture2D::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        CameraBlock camera{m_Proj * m_View};
+        m_Camera->SetData(&camera, sizeof(camera));
+        m_Camera->BindBase(CameraBinding);
+
+        m_Texture->Bind();
+        /* Bind and draw */
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), m_translationA);
+            m_Shader->Bind();
+            m_Shader->SetUniformMat4f("u_Model", model);
+            renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+        }
+
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), m_translationB);
+            m_Shader->Bind();
+            m_Shader->SetUniformMat4f("u_Model", model);
+            renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_Shader);
+        }
+    }
+    void TestTexture2D::OnImGuiRender()
+    {
+        ImGui::SliderFloat3("m_translationA", &m_translationA.x, 0.0f, 960.0f);
+        ImGui::SliderFloat3("m_translationB", &m_translationB.x, 0.0f, 960.0f);
+    }
+}
@@ -0,0 +1,130 @@
+#include "TestTextureAtlas.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sys/stat.h>
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    static const char *s_Directory = "/tmp/opengl_texture_atlas";
+
+    TestTextureAtlas::TestTextureAtlas() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f))
+    {
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        GenerateSprites();
+        m_BatchRenderer = std::make_unique<BatchRenderer>();
+
+        std::vector<std::string> equalPaths;
+        for (int i = 0; i < s_SpriteCount; ++i)
+        {
+            m_Textures.push_back(std::make_unique<Texture>(GetSpritePath(i, false)));
+            equalPaths.push_back(GetSpritePath(i, true));
+        }
+        m_Array = std::make_unique<TextureArray>(equalPaths);
+        BuildAtlas(true);
+    }
+    std::string TestTextureAtlas::GetSpritePath(int index, bool equalSize)
+    {
+        return std::string(s_Directory) + (equalSize ? "/equal_" : "/sprite_") + std::to_string(index) + ".ppm";
+    }
+    void TestTextureAtlas::GenerateSprites()
+    {
+        mkdir(s_Directory, 0755);
+        for (int equalSize = 0; equalSize < 2; ++equalSize)
+            for (int index = 0; index < s_SpriteCount; ++index)
+            {
+                std::string path = GetSpritePath(index, equalSize);
+                if (std::ifstream(path).good())
+                    continue;
+
+                /* Odd sizes between 20 and 95 pixels, or 64x64 for the array */
+                int width = equalSize ? 64 : 20 + (index * 37) % 76;
+                int height = equalSize ? 64 : 20 + (index * 53) % 76;
+                std::vector<unsigned char> pixels(width * height * 3);
+                for (int y = 0; y < height; ++y)
+                    for (int x = 0; x < width; ++x)
+                    {
+                        bool border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+                        bool checker = ((x / 8) + (y / 8)) % 2;
+                        unsigned char *pixel = &pixels[(y * width + x) * 3];
+                        pixel[0] = border ? 255 : (unsigned char)(index * 4 + (checker ? 0 : 64));
+                        pixel[1] = border ? 255 : (unsigned char)(255 - index * 3);
+                        pixel[2] = border ? 255 : (unsigned char)(checker ? 200 : 100);
+                    }
+                std::ofstream file(path, std::ios::binary);
+                file << "P6\n" << width << " " << height << "\n255\n";
+                file.write((const char *)pixels.data(), pixels.size());
+            }
+    }
+    void TestTextureAtlas::BuildAtlas(bool useCache)
+    {
+        int pageSize = s_PageSizes[m_PageSizeIndex];
+        std::string cachePath = std::string(s_Directory) + "/atlas_" + std::to_string(pageSize) + ".cache";
+        if (!useCache)
+            remove(cachePath.c_str());
+
+        m_Atlas = std::make_unique<TextureAtlas>(pageSize);
+        for (int i = 0; i < s_SpriteCount; ++i)
+            m_Atlas->Add(std::to_string(i), GetSpritePath(i, false));
+        m_Atlas->Build(cachePath);
+    }
+    void TestTextureAtlas::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        int columns = (int)std::ceil(std::sqrt(m_QuadCount * 960.0f / 540.0f));
+        int rows = (m_QuadCount + columns - 1) / columns;
+        glm::vec2 cell(960.0f / columns, 540.0f / rows);
+        glm::vec2 size = cell * 0.9f;
+
+        /* Neighbouring quads use different sprites, the worst case for slot reuse */
+        auto start = std::chrono::steady_clock::now();
+        m_BatchRenderer->ResetStats();
+        m_BatchRenderer->BeginBatch(m_Proj);
+        for (int i = 0; i < m_QuadCount; ++i)
+        {
+            glm::vec2 position((i % columns) * cell.x, (i / columns) * cell.y);
+            int sprite = (i * 7) % s_SpriteCount;
+            if (m_Mode == SeparateTextures)
+                m_BatchRenderer->SubmitQuad(position, size, *m_Textures[sprite]);
+            else if (m_Mode == Atlas)
+                m_BatchRenderer->SubmitQuad(position, size, *m_Atlas, m_Atlas->GetRegion(sprite));
+            else
+                m_BatchRenderer->SubmitQuad(position, size, *m_Array, sprite);
+        }
+        m_BatchRenderer->EndBatch();
+        m_SubmitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    void TestTextureAtlas::OnImGuiRender()
+    {
+        const char *modes[] = {"Texture per sprite", "Atlas", "Texture array"};
+        const char *pageSizes[] = {"256", "512", "1024"};
+        ImGui::Combo("Source", &m_Mode, modes, 3);
+        ImGui::SliderInt("Quads", &m_QuadCount, 1, 100000);
+        if (ImGui::Combo("Atlas page size", &m_PageSizeIndex, pageSizes, 3))
+            BuildAtlas(true);
+        if (ImGui::Button("Rebuild atlas without cache"))
+            BuildAtlas(false);
+
+        const BatchRenderer::Stats &stats = m_BatchRenderer->GetStats();
+        ImGui::Text("Draws per frame: %u, submit %.3f ms", stats.DrawCount, m_SubmitMs);
+        const TextureAtlas::Stats &atlas = m_Atlas->GetStats();
+        ImGui::Text("Atlas: %u pages, built in %.1f ms %s", m_Atlas->GetPageCount(), atlas.BuildMs,
+                    atlas.FromCache ? "(from cache)" : "(packed)");
+        if (!atlas.FromCache)
+            ImGui::Text("Page occupancy: %.0f%%", atlas.Occupancy * 100.0f);
+        ImGui::Text("Texture array: %d layers of %dx%d", m_Array->GetLayerCount(), m_Array->GetWidth(),
+                    m_Array->GetHeight());
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "Test.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../BatchRenderer.h"
+#include "../TextureArray.h"
+#include "../TextureAtlas.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Draws a grid of sprites from one texture per sprite, from an atlas
+     * (one or more pages, cached on disk) or from a texture array, and shows
+     * how many draw calls the batch renderer needs for each.
+     */
+    class TestTextureAtlas : public Test
+    {
+    public:
+        TestTextureAtlas();
+        ~TestTextureAtlas() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        enum Mode
+        {
+            SeparateTextures = 0,
+            Atlas = 1,
+            Array = 2
+        };
+
+        static constexpr int s_SpriteCount = 64;
+        static constexpr int s_PageSizes[3] = {256, 512, 1024};
+
+        static std::string GetSpritePath(int index, bool equalSize);
+        static void GenerateSprites();
+        void BuildAtlas(bool useCache);
+
+        std::unique_ptr<BatchRenderer> m_BatchRenderer;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::unique_ptr<TextureAtlas> m_Atlas;
+        std::unique_ptr<TextureArray> m_Array;
+
+        glm::mat4 m_Proj;
+        int m_Mode = Atlas;
+        int m_QuadCount = 10000;
+        int m_PageSizeIndex = 2;
+        double m_SubmitMs = 0.0;
+    };
+}
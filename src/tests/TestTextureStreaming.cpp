@@ -0,0 +1,135 @@
+#include "TestTextureStreaming.h"
+
+#include <cmath>
+#include <fstream>
+#include <sys/stat.h>
+
+#include "../StagingPool.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    static const int s_Sizes[3] = {256, 512, 1024};
+
+    TestTextureStreaming::TestTextureStreaming() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                                   m_LastFrame(std::chrono::steady_clock::now())
+    {
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_BatchRenderer = std::make_unique<BatchRenderer>();
+        m_Loader = std::make_unique<TextureLoader>();
+    }
+    std::string TestTextureStreaming::GetImagePath(int index) const
+    {
+        return "/tmp/opengl_texture_streaming/" + std::to_string(s_Sizes[m_SizeIndex]) + "_" +
+               std::to_string(index) + ".ppm";
+    }
+    void TestTextureStreaming::GenerateImages()
+    {
+        mkdir("/tmp/opengl_texture_streaming", 0755);
+        int size = s_Sizes[m_SizeIndex];
+        std::vector<unsigned char> pixels(size * size * 3);
+        for (int index = 0; index < s_DistinctImages; ++index)
+        {
+            std::string path = GetImagePath(index);
+            if (std::ifstream(path).good())
+                continue;
+
+            /* Rings with a per-image hue, enough detail to see filtering */
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                {
+                    float dx = x - size * 0.5f, dy = y - size * 0.5f;
+                    float ring = 0.5f + 0.5f * std::sin(std::sqrt(dx * dx + dy * dy) * 0.2f + index);
+                    unsigned char *pixel = &pixels[(y * size + x) * 3];
+                    pixel[0] = (unsigned char)(255 * ring * ((index & 1) ? 1.0f : 0.3f));
+                    pixel[1] = (unsigned char)(255 * ring * ((index & 2) ? 1.0f : 0.3f));
+                    pixel[2] = (unsigned char)(255 * ring * ((index & 4) ? 1.0f : 0.3f));
+                }
+            std::ofstream file(path, std::ios::binary);
+            file << "P6\n" << size << " " << size << "\n255\n";
+            file.write((const char *)pixels.data(), pixels.size());
+        }
+    }
+    void TestTextureStreaming::StartLoad()
+    {
+        GenerateImages();
+        m_Textures.clear();
+        m_LoadStart = std::chrono::steady_clock::now();
+        m_LoadMaxFrameMs = 0.0f;
+        m_Loading = true;
+        for (int i = 0; i < m_Count; ++i)
+        {
+            if (m_Streaming)
+                m_Textures.push_back(m_Loader->Load(GetImagePath(i % s_DistinctImages)));
+            else
+                m_Textures.push_back(std::make_shared<Texture>(GetImagePath(i % s_DistinctImages)));
+        }
+    }
+    void TestTextureStreaming::OnRender()
+    {
+        auto now = std::chrono::steady_clock::now();
+        float frameMs = std::chrono::duration<float, std::milli>(now - m_LastFrame).count();
+        m_LastFrame = now;
+        m_FrameMs[m_HistoryIndex] = frameMs;
+        m_HistoryIndex = (m_HistoryIndex + 1) % s_HistorySize;
+
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        m_Loader->Update(m_BudgetMs);
+        if (m_Loading)
+        {
+            m_LoadMaxFrameMs = std::max(m_LoadMaxFrameMs, frameMs);
+            if (m_Loader->GetPendingCount() == 0)
+            {
+                m_Loading = false;
+                m_LoadTotalMs = std::chrono::duration<double, std::milli>(now - m_LoadStart).count();
+            }
+        }
+
+        /* Every texture on a grid, placeholders show up grey */
+        int count = m_Textures.size();
+        if (count == 0)
+            return;
+        int columns = (int)std::ceil(std::sqrt(count * 960.0f / 540.0f));
+        int rows = (count + columns - 1) / columns;
+        glm::vec2 cell(960.0f / columns, 540.0f / rows);
+
+        m_BatchRenderer->BeginBatch(m_Proj);
+        for (int i = 0; i < count; ++i)
+        {
+            glm::vec2 position((i % columns) * cell.x, (i / columns) * cell.y);
+            m_BatchRenderer->SubmitQuad(position, cell * 0.9f, *m_Textures[i]);
+        }
+        m_BatchRenderer->EndBatch();
+    }
+    void TestTextureStreaming::OnImGuiRender()
+    {
+        const char *sizes[] = {"256x256", "512x512", "1024x1024"};
+        ImGui::SliderInt("Textures", &m_Count, 1, 1000);
+        ImGui::Combo("Size", &m_SizeIndex, sizes, 3);
+        ImGui::Checkbox("Stream (worker decode + PBO upload)", &m_Streaming);
+        ImGui::SliderFloat("Upload budget (ms/frame)", &m_BudgetMs, 0.25f, 16.0f);
+        if (!m_Loading && ImGui::Button("Load"))
+            StartLoad();
+
+        ImGui::PlotLines("Frame (ms)", m_FrameMs.data(), s_HistorySize, m_HistoryIndex, nullptr, 0.0f, 50.0f,
+                         ImVec2(0, 80));
+        TextureLoader::Stats stats = m_Loader->GetStats();
+        ImGui::Text("Pending %u, completed %u, failed %u", m_Loader->GetPendingCount(), stats.Completed, stats.Failed);
+        ImGui::Text("Upload %.2f ms, %.2f MB last frame, decode %.0f ms total on workers", stats.UploadMs,
+                    stats.UploadedBytes / (1024.0 * 1024.0), stats.DecodeMs);
+        ImGui::Text("Last load: %.0f ms total, worst frame %.1f ms", m_LoadTotalMs, m_LoadMaxFrameMs);
+        StagingPool::Stats pool = StagingPool::GetStats();
+        ImGui::Text("Staging pool: %u of %u allocations reused, %.1f MB cached", pool.Reuses, pool.Allocations,
+                    pool.CachedBytes / (1024.0 * 1024.0));
+    }
+}
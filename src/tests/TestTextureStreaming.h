@@ -0,0 +1,64 @@
+#pragma once
+#include "Test.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../BatchRenderer.h"
+#include "../TextureLoader.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Loads hundreds of textures at once, either synchronously (stb_image and
+     * glTexImage2D on the render thread) or through TextureLoader, and plots
+     * the frame time while they come in. The images are generated PPM files
+     * so their size can be chosen.
+     */
+    class TestTextureStreaming : public Test
+    {
+    public:
+        TestTextureStreaming();
+        ~TestTextureStreaming() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        static constexpr int s_DistinctImages = 16;
+        static constexpr int s_HistorySize = 240;
+
+        std::string GetImagePath(int index) const;
+        void GenerateImages();
+        void StartLoad();
+
+        std::unique_ptr<BatchRenderer> m_BatchRenderer;
+        std::unique_ptr<TextureLoader> m_Loader;
+        std::vector<std::shared_ptr<Texture>> m_Textures;
+
+        glm::mat4 m_Proj;
+        int m_Count = 300;
+        int m_SizeIndex = 1; // 256, 512, 1024
+        bool m_Streaming = true;
+        float m_BudgetMs = 2.0f;
+
+        std::chrono::steady_clock::time_point m_LastFrame;
+        std::array<float, s_HistorySize> m_FrameMs{};
+        int m_HistoryIndex = 0;
+        bool m_Loading = false;
+        std::chrono::steady_clock::time_point m_LoadStart;
+        double m_LoadTotalMs = 0.0;
+        float m_LoadMaxFrameMs = 0.0f;
+    };
+}
@@ -0,0 +1,178 @@
+#include "TestTransforms.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestTransforms::TestTransforms() : m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                       m_Sweep({"Per object glm", "SoA SIMD", "SoA SIMD + jobs"}, {"Update (ms)"})
+    {
+        float positions[] = {-0.5f, -0.5f, 0.0f, 0.0f, 0.5f, -0.5f, 1.0f, 0.0f,
+                             0.5f, 0.5f, 1.0f, 1.0f, -0.5f, 0.5f, 0.0f, 1.0f};
+        uint indices[] = {0, 1, 2, 2, 3, 0};
+
+        /* Mesh attributes use locations 0 and 1, the world matrix continues at 2 */
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_Instances.resize(s_DrawnRoots * s_SubtreeSize);
+        m_InstanceBuffer = std::make_unique<VertexBuffer>(m_Instances.size() * sizeof(glm::mat4));
+        VertexBufferLayout instanceLayout;
+        for (int column = 0; column < 4; ++column)
+            instanceLayout.Push<float>(4, 1);
+        m_VertexArray->AddBuffer(*m_InstanceBuffer, instanceLayout);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"INSTANCED"});
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+
+        m_Sweep.SetShowSpeedup(true);
+        CreateHierarchy();
+    }
+    void TestTransforms::CreateHierarchy()
+    {
+        /* Depth first, so the subtree of root r is [r * s_SubtreeSize, (r + 1) * s_SubtreeSize) */
+        uint count = s_RootCount * s_SubtreeSize;
+        m_Transforms.Reserve(count);
+        m_Nodes.reserve(count);
+        m_GlmWorld.resize(count);
+        auto create = [this](uint parent, const glm::vec3 &position, float angle, float scale) {
+            TransformID id = m_Transforms.Create(parent);
+            m_Transforms.SetPosition(id, position);
+            m_Transforms.SetRotation(id, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            m_Transforms.SetScale(id, glm::vec3(scale));
+            m_Nodes.push_back({position, angle, glm::vec3(scale), parent});
+            return id;
+        };
+
+        /* The drawn roots fill a 10 x 10 grid, the others repeat it off screen */
+        for (uint root = 0; root < s_RootCount; ++root)
+        {
+            glm::vec3 center((root % 10 + 0.5f) * 96.0f, (root / 10 % 10 + 0.5f) * 54.0f, 0.0f);
+            TransformID rootID = create(TransformSystem::NoParent, center, 0.0f, 12.0f);
+            for (uint child = 0; child < s_Children; ++child)
+            {
+                float angle = child * 6.2831853f / s_Children;
+                glm::vec3 offset(std::cos(angle) * 1.8f, std::sin(angle) * 1.8f, 0.0f);
+                TransformID childID = create(rootID, offset, angle, 0.35f);
+                for (uint grandChild = 0; grandChild < s_GrandChildren; ++grandChild)
+                {
+                    float around = grandChild * 6.2831853f / s_GrandChildren;
+                    create(childID, glm::vec3(std::cos(around) * 1.6f, std::sin(around) * 1.6f, 0.0f), around, 0.25f);
+                }
+            }
+        }
+    }
+    void TestTransforms::OnUpdate(float deltaTime)
+    {
+        m_Time += deltaTime;
+    }
+    void TestTransforms::Animate(uint roots)
+    {
+        for (uint root = 0; root < roots; ++root)
+        {
+            TransformID id = root * s_SubtreeSize;
+            float angle = m_Time * (0.5f + (root % 7) * 0.25f);
+            m_Transforms.SetRotation(id, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            m_Nodes[id].Angle = angle;
+        }
+    }
+    double TestTransforms::UpdateWorld(Mode mode)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (mode == Glm)
+        {
+            /* Parents always come before their children */
+            for (size_t id = 0; id < m_Nodes.size(); ++id)
+            {
+                const Node &node = m_Nodes[id];
+                glm::mat4 local = glm::translate(glm::mat4(1.0f), node.Position);
+                local = glm::rotate(local, node.Angle, glm::vec3(0.0f, 0.0f, 1.0f));
+                local = glm::scale(local, node.Scale);
+                m_GlmWorld[id] = node.Parent == TransformSystem::NoParent ? local : m_GlmWorld[node.Parent] * local;
+            }
+        }
+        else
+            m_Transforms.Update(mode == SimdJobs ? &JobSystem::Get() : nullptr);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    const glm::mat4 &TestTransforms::GetWorld(Mode mode, uint id) const
+    {
+        return mode == Glm ? m_GlmWorld[id] : m_Transforms.GetWorld(id);
+    }
+    float TestTransforms::CompareToGlm()
+    {
+        /* Bring glm up to the angles the TransformSystem saw last */
+        UpdateWorld(Glm);
+        float maxError = 0.0f;
+        for (uint id = 0; id < m_GlmWorld.size(); ++id)
+        {
+            const glm::mat4 &expected = m_GlmWorld[id];
+            const glm::mat4 &world = m_Transforms.GetWorld(id);
+            for (int column = 0; column < 4; ++column)
+                for (int row = 0; row < 4; ++row)
+                    maxError = std::max(maxError, std::abs(world[column][row] - expected[column][row]) /
+                                                      std::max(1.0f, std::abs(expected[column][row])));
+        }
+        return maxError;
+    }
+    void TestTransforms::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        /* Benchmark: one path per step, every root spinning, nothing drawn meanwhile */
+        if (m_Sweep.IsRunning())
+        {
+            Animate(s_RootCount);
+            if (m_Sweep.Record({UpdateWorld((Mode)m_Sweep.GetStep())}))
+            {
+                m_MaxError = CompareToGlm();
+                m_Sweep.Check(m_MaxError <= s_Tolerance, "TransformSystem differs from glm by " +
+                                                             std::to_string(m_MaxError) + " (relative)");
+            }
+            return;
+        }
+
+        Animate((uint)(m_Animated * s_RootCount));
+        m_UpdateMs = UpdateWorld((Mode)m_Mode);
+        for (uint id = 0; id < m_Instances.size(); ++id)
+            m_Instances[id] = GetWorld((Mode)m_Mode, id);
+        m_InstanceBuffer->SetData(m_Instances.data(), m_Instances.size() * sizeof(glm::mat4));
+
+        CameraBlock camera{m_Proj};
+        m_Camera->SetData(&camera, sizeof(camera));
+        m_Camera->BindBase(CameraBinding);
+        m_Shader->Bind();
+        m_Shader->SetUniform4f("u_Color", 0.3f, 0.7f, 1.0f, 1.0f);
+        renderer.DrawInstanced(*m_VertexArray, *m_IndexBuffer, *m_Shader, m_Instances.size());
+    }
+    void TestTransforms::OnImGuiRender()
+    {
+        const char *modes[] = {"Per object glm", "SoA SIMD", "SoA SIMD + jobs"};
+        ImGui::Combo("Path", &m_Mode, modes, ModeCount);
+        ImGui::SliderFloat("Animated roots", &m_Animated, 0.0f, 1.0f);
+        ImGui::Text("%u transforms, %u levels, drawing %zu", m_Transforms.GetCount(), m_Transforms.GetDepth(),
+                    m_Instances.size());
+        ImGui::Text("Update %.3f ms", m_UpdateMs);
+        if (m_Mode != Glm)
+        {
+            const TransformSystem::Stats &stats = m_Transforms.GetStats();
+            ImGui::Text("%u local, %u world matrices recomputed", stats.LocalUpdates, stats.WorldUpdates);
+        }
+
+        m_Sweep.OnImGuiRender();
+        ImGui::Text("Max difference to glm: %g (limit %g)", m_MaxError, s_Tolerance);
+    }
+}
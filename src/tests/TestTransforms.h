@@ -0,0 +1,95 @@
+#pragma once
+#include "Test.h"
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Benchmark.h"
+#include "../Renderer.h"
+#include "../JobSystem.h"
+#include "../UniformBuffer.h"
+#include "../ShaderLibrary.h"
+#include "../TransformSystem.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * A million transforms in three levels: 10k spinning roots with 9
+     * children of 10 children each. World matrices are computed per object
+     * with glm (translate * rotate * scale, then parent * local), or by the
+     * TransformSystem on one thread or on the JobSystem. Only the subtrees
+     * of the first 100 roots are drawn. "Run benchmark" animates every root
+     * and times each path, then checks the TransformSystem against glm.
+     */
+    class TestTransforms : public Test
+    {
+    public:
+        TestTransforms();
+        ~TestTransforms() {}
+        void OnUpdate(float deltaTime) override;
+        void OnRender() override;
+        void OnImGuiRender() override;
+        BenchmarkSweep *GetBenchmarkSweep() override { return &m_Sweep; }
+
+    private:
+        static constexpr uint s_RootCount = 10000;
+        static constexpr uint s_Children = 9;
+        static constexpr uint s_GrandChildren = 10;
+        static constexpr uint s_SubtreeSize = 1 + s_Children * (1 + s_GrandChildren); // Consecutive IDs per root
+        static constexpr uint s_DrawnRoots = 100;
+        static constexpr float s_Tolerance = 1e-4f; // Relative to the larger of 1 and the glm value
+
+        enum Mode
+        {
+            Glm,
+            Simd,
+            SimdJobs,
+            ModeCount
+        };
+
+        /* What a typical scene graph node stores, for the glm path */
+        struct Node
+        {
+            glm::vec3 Position;
+            float Angle;
+            glm::vec3 Scale;
+            uint Parent; // TransformSystem::NoParent for roots
+        };
+
+        void CreateHierarchy();
+        void Animate(uint roots);
+        // Returns the time in ms
+        double UpdateWorld(Mode mode);
+        const glm::mat4 &GetWorld(Mode mode, uint id) const;
+        // Largest relative difference between the glm and TransformSystem world matrices
+        float CompareToGlm();
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::shared_ptr<Shader> m_Shader;
+        std::unique_ptr<UniformBuffer> m_Camera;
+
+        TransformSystem m_Transforms;
+        std::vector<Node> m_Nodes;
+        std::vector<glm::mat4> m_GlmWorld;
+        std::vector<glm::mat4> m_Instances;
+
+        glm::mat4 m_Proj;
+        float m_Time = 0.0f;
+        float m_Animated = 1.0f; // Fraction of the roots that spin
+        int m_Mode = SimdJobs;
+        double m_UpdateMs = 0.0;
+        float m_MaxError = 0.0f; // From CompareToGlm() after a benchmark
+        BenchmarkSweep m_Sweep;  // One step per Mode
+    };
+}
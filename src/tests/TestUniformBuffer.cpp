@@ -0,0 +1,150 @@
+#include "TestUniformBuffer.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestUniformBuffer::TestUniformBuffer() : m_Models(s_ObjectCount),
+                                             m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+                                             m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0))),
+                                             m_Sweep({"Per draw MVP", "Camera UBO + model", "Object UBO + index"},
+                                                     {"Submit (ms)", "Frame (ms)"})
+    {
+        float positions[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f, // 0
+            0.5f, -0.5f, 1.0f, 0.0f,  // 1
+            0.5f, 0.5f, 1.0f, 1.0f,   // 2
+            -0.5f, 0.5f, 0.0f, 1.0f   // 3
+        };
+        uint indices[] = {0, 1, 2, 2, 3, 0};
+
+        /* Show alpha channels correctly */
+        GLStateCache::Get().Enable(GL_BLEND);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_VertexArray = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 4 * 4 * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VertexArray->AddBuffer(*m_VertexBuffer, layout);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_MVPShader = ShaderLibrary::Get().Load("res/shaders/MVP.shader");
+        m_ModelShader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED"});
+        m_ObjectsShader = ShaderLibrary::Get().Load("res/shaders/Objects.shader");
+        for (Shader *shader : {m_MVPShader.get(), m_ModelShader.get(), m_ObjectsShader.get()})
+        {
+            shader->Bind();
+            shader->SetUniform1i("u_Texture", 0);
+        }
+        m_Texture = std::make_unique<Texture>("res/textures/icon.png");
+        m_MVPHandle = m_MVPShader->GetUniformHandle("u_MVP");
+        m_ModelHandle = m_ModelShader->GetUniformHandle("u_Model");
+        m_ObjectIndexHandle = m_ObjectsShader->GetUniformHandle("u_ObjectIndex");
+
+        /* Every range starts on an aligned offset, so pad the stride if needed */
+        UniformBlockLayout objects;
+        objects.Push<glm::mat4>(s_ObjectsPerRange);
+        uint alignment = UniformBuffer::GetOffsetAlignment();
+        m_RangeStride = (objects.GetSize() + alignment - 1) / alignment * alignment;
+        uint rangeCount = (s_ObjectCount + s_ObjectsPerRange - 1) / s_ObjectsPerRange;
+        m_Camera = std::make_unique<UniformBuffer>(sizeof(CameraBlock));
+        m_Objects = std::make_unique<UniformBuffer>(rangeCount * m_RangeStride);
+    }
+    void TestUniformBuffer::UpdateModels()
+    {
+        /* Grid that fills the window, every square spinning in place */
+        int columns = (int)std::ceil(std::sqrt(s_ObjectCount * 960.0f / 540.0f));
+        int rows = (s_ObjectCount + columns - 1) / columns;
+        glm::vec2 cell(960.0f / columns, 540.0f / rows);
+
+        for (int i = 0; i < s_ObjectCount; ++i)
+        {
+            glm::vec3 center((i % columns + 0.5f) * cell.x, (i / columns + 0.5f) * cell.y, 0.0f);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), center);
+            model = glm::rotate(model, m_Rotation + i * 0.01f, glm::vec3(0, 0, 1));
+            m_Models[i] = glm::scale(model, glm::vec3(cell * 0.7f, 1.0f));
+        }
+    }
+    void TestUniformBuffer::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        Renderer renderer;
+        renderer.Clear();
+
+        if (m_Sweep.IsRunning())
+            m_Mode = m_Sweep.GetStep();
+        m_Rotation += 0.01f;
+        UpdateModels();
+
+        auto start = std::chrono::steady_clock::now();
+        m_Texture->Bind();
+        glm::mat4 viewProj = m_Proj * m_View;
+        if (m_Mode == PerDrawMVP)
+        {
+            /* Before: proj * view * model on the CPU and a mat4 upload per draw */
+            m_MVPShader->Bind();
+            for (const glm::mat4 &model : m_Models)
+            {
+                m_MVPShader->SetUniformMat4f(m_MVPHandle, viewProj * model);
+                renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_MVPShader);
+            }
+        }
+        else
+        {
+            CameraBlock camera{viewProj};
+            m_Camera->SetData(&camera, sizeof(camera));
+            m_Camera->BindBase(CameraBinding);
+
+            if (m_Mode == CameraBlockModel)
+            {
+                m_ModelShader->Bind();
+                for (const glm::mat4 &model : m_Models)
+                {
+                    m_ModelShader->SetUniformMat4f(m_ModelHandle, model);
+                    renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_ModelShader);
+                }
+            }
+            else
+            {
+                /* One upload per range, then only an int per draw */
+                for (int first = 0; first < s_ObjectCount; first += s_ObjectsPerRange)
+                {
+                    int count = std::min(s_ObjectsPerRange, s_ObjectCount - first);
+                    m_Objects->SetData(&m_Models[first], count * sizeof(glm::mat4),
+                                       first / s_ObjectsPerRange * m_RangeStride);
+                }
+                m_ObjectsShader->Bind();
+                for (int i = 0; i < s_ObjectCount; ++i)
+                {
+                    if (i % s_ObjectsPerRange == 0)
+                        m_Objects->BindRange(ObjectsBinding, i / s_ObjectsPerRange * m_RangeStride,
+                                             s_ObjectsPerRange * sizeof(glm::mat4));
+                    m_ObjectsShader->SetUniform1i(m_ObjectIndexHandle, i % s_ObjectsPerRange);
+                    renderer.Draw(*m_VertexArray, *m_IndexBuffer, *m_ObjectsShader);
+                }
+            }
+        }
+        auto submitted = std::chrono::steady_clock::now();
+        GLCall(glFinish());
+        auto finished = std::chrono::steady_clock::now();
+
+        m_Last.SubmitMs = std::chrono::duration<double, std::milli>(submitted - start).count();
+        m_Last.FrameMs = std::chrono::duration<double, std::milli>(finished - start).count();
+
+        m_Sweep.Record({m_Last.SubmitMs, m_Last.FrameMs});
+    }
+    void TestUniformBuffer::OnImGuiRender()
+    {
+        const char *modes[] = {"Per draw MVP", "Camera UBO + model", "Object UBO + index"};
+        ImGui::Combo("Upload", &m_Mode, modes, 3);
+        ImGui::Text("Objects: %d", s_ObjectCount);
+        ImGui::Text("Submit %.3f ms, frame %.3f ms", m_Last.SubmitMs, m_Last.FrameMs);
+
+        m_Sweep.OnImGuiRender();
+    }
+}
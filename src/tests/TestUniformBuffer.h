@@ -0,0 +1,83 @@
+#pragma once
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../Util.h"
+#include "../Benchmark.h"
+#include "../Renderer.h"
+#include "../Texture.h"
+#include "../UniformBuffer.h"
+#include "../ShaderLibrary.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Draws 10k moving squares with one draw call each and compares how the
+     * transforms reach the GPU: a full MVP uniform per draw, a camera block
+     * uploaded once plus a model matrix per draw, or every model matrix in a
+     * per-object UBO uploaded once with only an index set per draw.
+     */
+    class TestUniformBuffer : public Test
+    {
+    public:
+        TestUniformBuffer();
+        ~TestUniformBuffer() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+        BenchmarkSweep *GetBenchmarkSweep() override { return &m_Sweep; }
+
+    private:
+        enum Mode
+        {
+            PerDrawMVP = 0,
+            CameraBlockModel = 1,
+            ObjectBlockIndex = 2
+        };
+
+        static constexpr int s_ObjectCount = 10000;
+        static constexpr int s_ObjectsPerRange = 256; // Must match u_Models in Objects.shader
+
+        struct Result
+        {
+            double SubmitMs = 0.0; // CPU time spent computing and uploading transforms and drawing
+            double FrameMs = 0.0;  // Including glFinish, i.e. until the GPU is done
+        };
+
+        void UpdateModels();
+
+        std::unique_ptr<VertexArray> m_VertexArray;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::shared_ptr<Shader> m_MVPShader;
+        std::shared_ptr<Shader> m_ModelShader;
+        std::shared_ptr<Shader> m_ObjectsShader;
+        std::unique_ptr<Texture> m_Texture;
+        UniformHandle m_MVPHandle;
+        UniformHandle m_ModelHandle;
+        UniformHandle m_ObjectIndexHandle;
+        std::unique_ptr<UniformBuffer> m_Camera;
+        std::unique_ptr<UniformBuffer> m_Objects;
+        std::vector<glm::mat4> m_Models;
+        uint m_RangeStride; // Bytes between ranges, respecting the offset alignment
+
+        glm::mat4 m_Proj;
+        glm::mat4 m_View;
+        float m_Rotation = 0.0f;
+        int m_Mode = CameraBlockModel;
+        Result m_Last;
+        BenchmarkSweep m_Sweep; // One step per Mode
+    };
+}
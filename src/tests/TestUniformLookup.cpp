@@ -0,0 +1,75 @@
+#include "TestUniformLookup.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Implementation
+    // ============================================================================
+
+    TestUniformLookup::TestUniformLookup()
+    {
+        m_Shader = ShaderLibrary::Get().Load("res/shaders/Basic.shader", {"TEXTURED"});
+        m_ModelHandle = m_Shader->GetUniformHandle("u_Model");
+    }
+    int TestUniformLookup::LegacyLookup(const std::string &name)
+    {
+        if (m_LegacyCache.count(name))
+            return m_LegacyCache.at(name);
+        GLCall(int location = glGetUniformLocation(m_Shader->GetRendererID(), name.c_str()));
+        m_LegacyCache[name] = location;
+        return location;
+    }
+    void TestUniformLookup::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Shader->Bind();
+        glm::mat4 model(1.0f);
+        for (int path = 0; path < 3; ++path)
+        {
+            /* Lookup only, the sink keeps the loop from being optimized away */
+            volatile int sink = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < m_Iterations; ++i)
+            {
+                if (path == StringMap)
+                    sink = sink + LegacyLookup("u_Model");
+                else if (path == Name)
+                    sink = sink + m_Shader->GetUniformHandle("u_Model").Index;
+                else
+                    sink = sink + m_ModelHandle.Index;
+            }
+            auto looked = std::chrono::steady_clock::now();
+
+            /* The same with the upload each draw would do */
+            for (int i = 0; i < m_Iterations; ++i)
+            {
+                if (path == StringMap)
+                {
+                    GLCall(glUniformMatrix4fv(LegacyLookup("u_Model"), 1, GL_FALSE, &model[0][0]));
+                }
+                else if (path == Name)
+                    m_Shader->SetUniformMat4f("u_Model", model);
+                else
+                    m_Shader->SetUniformMat4f(m_ModelHandle, model);
+            }
+            auto uploaded = std::chrono::steady_clock::now();
+
+            double lookupNs = std::chrono::duration<double, std::nano>(looked - start).count() / m_Iterations;
+            double uploadNs = std::chrono::duration<double, std::nano>(uploaded - looked).count() / m_Iterations;
+            m_Results[path].LookupNs += 0.1 * (lookupNs - m_Results[path].LookupNs);
+            m_Results[path].UploadNs += 0.1 * (uploadNs - m_Results[path].UploadNs);
+        }
+    }
+    void TestUniformLookup::OnImGuiRender()
+    {
+        ImGui::SliderInt("Iterations", &m_Iterations, 1000, 1000000);
+
+        const char *paths[] = {"std::string map", "UniformName", "UniformHandle"};
+        ImGui::Text("%-16s %12s %14s", "Path", "Lookup (ns)", "+ upload (ns)");
+        for (int path = 0; path < 3; ++path)
+            ImGui::Text("%-16s %12.2f %14.2f", paths[path], m_Results[path].LookupNs, m_Results[path].UploadNs);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Test.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "../Util.h"
+#include "../ShaderLibrary.h"
+
+namespace test
+{
+
+    // ============================================================================
+    // Class definition
+    // ============================================================================
+
+    /*
+     * Microbenchmark for uniform location lookup. Every frame resolves (and
+     * uploads) u_Model many times through the old std::string keyed map, the
+     * name based setters and a pre-resolved UniformHandle.
+     */
+    class TestUniformLookup : public Test
+    {
+    public:
+        TestUniformLookup();
+        ~TestUniformLookup() {}
+        void OnUpdate(float deltaTime) override {}
+        void OnRender() override;
+        void OnImGuiRender() override;
+
+    private:
+        enum Path
+        {
+            StringMap = 0,
+            Name = 1,
+            Handle = 2
+        };
+
+        struct Result
+        {
+            double LookupNs = 0.0; // Per lookup, no GL call
+            double UploadNs = 0.0; // Per lookup + glUniformMatrix4fv
+        };
+
+        // What Shader::GetUniformLocation used to do
+        int LegacyLookup(const std::string &name);
+
+        std::shared_ptr<Shader> m_Shader;
+        std::unordered_map<std::string, int> m_LegacyCache;
+        UniformHandle m_ModelHandle;
+
+        int m_Iterations = 100000;
+        Result m_Results[3]; // Smoothed over frames
+    };
+}
@@ -0,0 +1,66 @@
+// Packs files into an AssetPack archive the app maps at startup.
+//
+// Usage: assetpack output.pack <file or directory>...
+// Directories are walked recursively (dot files skipped); paths are stored
+// as given, so run it from the repository root like the app itself.
+
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "AssetPack.h"
+
+static void CollectFiles(const std::string &path, std::vector<std::string> &files)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        std::cout << "Skipping " << path << ": not found" << std::endl;
+        return;
+    }
+    if (!S_ISDIR(info.st_mode))
+    {
+        files.push_back(path);
+        return;
+    }
+
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return;
+    while (dirent *entry = readdir(dir))
+        if (entry->d_name[0] != '.')
+            CollectFiles(path + '/' + entry->d_name, files);
+    closedir(dir);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: assetpack output.pack <file or directory>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string path = argv[i];
+        while (path.size() > 1 && path.back() == '/')
+            path.pop_back();
+        CollectFiles(path, files);
+    }
+    if (!AssetPack::Write(argv[1], files))
+    {
+        std::cout << "Failed to write " << argv[1] << std::endl;
+        return 1;
+    }
+
+    AssetPack pack(argv[1]);
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < pack.GetAssetCount(); ++i)
+        bytes += pack.GetAsset(i).Size;
+    std::cout << argv[1] << ": " << pack.GetAssetCount() << " files, " << bytes << " bytes" << std::endl;
+    return pack.IsValid() ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+// Offline texture converter: decodes an image, builds its mip chain and
+// writes a KTX file the app uploads without decoding.
+//
+// Usage: texconv [--format auto|bc1|bc3|rgba8] input.png output.ktx
+//  auto  - BC3 if any pixel is not fully opaque, BC1 otherwise (default)
+//  bc1   - 4 bpp, opaque (S3TC DXT1)
+//  bc3   - 8 bpp, interpolated alpha (S3TC DXT5)
+//  rgba8 - uncompressed, still saves the PNG decode and mip generation
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "KtxFile.h"
+#include "Mipmap.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "vendor/stb_image/stb_image.h"
+
+// No GL headers in the tool, only the enums KTX stores
+enum : uint32_t
+{
+    GL_UNSIGNED_BYTE = 0x1401,
+    GL_RGB = 0x1907,
+    GL_RGBA = 0x1908,
+    GL_RGBA8 = 0x8058,
+    GL_COMPRESSED_RGB_S3TC_DXT1_EXT = 0x83F0,
+    GL_COMPRESSED_RGBA_S3TC_DXT5_EXT = 0x83F3
+};
+
+enum class Format
+{
+    Auto,
+    BC1,
+    BC3,
+    RGBA8
+};
+
+// ============================================================================
+// BC1 / BC3 block encoding
+// ============================================================================
+
+struct Color
+{
+    float R, G, B;
+};
+
+static uint16_t PackColor565(const Color &color)
+{
+    int r = std::min(31, std::max(0, (int)std::lround(color.R * 31.0f / 255.0f)));
+    int g = std::min(63, std::max(0, (int)std::lround(color.G * 63.0f / 255.0f)));
+    int b = std::min(31, std::max(0, (int)std::lround(color.B * 31.0f / 255.0f)));
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static Color UnpackColor565(uint16_t packed)
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    return {(float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2))};
+}
+
+static float Distance(const unsigned char *pixel, const Color &color)
+{
+    float r = pixel[0] - color.R, g = pixel[1] - color.G, b = pixel[2] - color.B;
+    return r * r + g * g + b * b;
+}
+
+// Picks the nearest of the four palette entries per pixel, returns the total error
+static float ChooseIndices(const unsigned char pixels[16][4], uint16_t c0, uint16_t c1, uint32_t &indices)
+{
+    Color a = UnpackColor565(c0), b = UnpackColor565(c1);
+    Color palette[4] = {a, b, {(2 * a.R + b.R) / 3, (2 * a.G + b.G) / 3, (2 * a.B + b.B) / 3},
+                        {(a.R + 2 * b.R) / 3, (a.G + 2 * b.G) / 3, (a.B + 2 * b.B) / 3}};
+    float error = 0.0f;
+    indices = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int best = 0;
+        float bestDistance = Distance(pixels[i], palette[0]);
+        for (int j = 1; j < 4; ++j)
+        {
+            float distance = Distance(pixels[i], palette[j]);
+            if (distance < bestDistance)
+            {
+                best = j;
+                bestDistance = distance;
+            }
+        }
+        indices |= (uint32_t)best << (2 * i);
+        error += bestDistance;
+    }
+    return error;
+}
+
+// Least squares endpoints for fixed indices
+static bool RefitEndpoints(const unsigned char pixels[16][4], uint32_t indices, Color &a, Color &b)
+{
+    static const float s_Weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f}; // Share of endpoint a
+    float aa = 0, ab = 0, bb = 0;
+    Color ax = {0, 0, 0}, bx = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+    {
+        float w = s_Weights[(indices >> (2 * i)) & 3], v = 1.0f - w;
+        aa += w * w;
+        ab += w * v;
+        bb += v * v;
+        ax = {ax.R + w * pixels[i][0], ax.G + w * pixels[i][1], ax.B + w * pixels[i][2]};
+        bx = {bx.R + v * pixels[i][0], bx.G + v * pixels[i][1], bx.B + v * pixels[i][2]};
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+    float inverse = 1.0f / determinant;
+    a = {(ax.R * bb - bx.R * ab) * inverse, (ax.G * bb - bx.G * ab) * inverse, (ax.B * bb - bx.B * ab) * inverse};
+    b = {(bx.R * aa - ax.R * ab) * inverse, (bx.G * aa - ax.G * ab) * inverse, (bx.B * aa - ax.B * ab) * inverse};
+    return true;
+}
+
+// 4 color mode only (c0 > c1), as BC3 requires and opaque BC1 allows
+static void EncodeColorBlock(const unsigned char pixels[16][4], unsigned char *out)
+{
+    /* Endpoints along the principal axis of the block's colors */
+    Color mean = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        mean = {mean.R + pixels[i][0] / 16.0f, mean.G + pixels[i][1] / 16.0f, mean.B + pixels[i][2] / 16.0f};
+    float covariance[6] = {}; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i)
+    {
+        float r = pixels[i][0] - mean.R, g = pixels[i][1] - mean.G, b = pixels[i][2] - mean.B;
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+    Color axis = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        Color next = {covariance[0] * axis.R + covariance[1] * axis.G + covariance[2] * axis.B,
+                      covariance[1] * axis.R + covariance[3] * axis.G + covariance[4] * axis.B,
+                      covariance[2] * axis.R + covariance[4] * axis.G + covariance[5] * axis.B};
+        float length = std::sqrt(next.R * next.R + next.G * next.G + next.B * next.B);
+        if (length < 1e-6f)
+            break;
+        axis = {next.R / length, next.G / length, next.B / length};
+    }
+    float low = 0.0f, high = 0.0f;
+    for (int i = 0; i < 16; ++i)
+    {
+        float t = (pixels[i][0] - mean.R) * axis.R + (pixels[i][1] - mean.G) * axis.G +
+                  (pixels[i][2] - mean.B) * axis.B;
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    Color a = {mean.R + axis.R * high, mean.G + axis.G * high, mean.B + axis.B * high};
+    Color b = {mean.R + axis.R * low, mean.G + axis.G * low, mean.B + axis.B * low};
+
+    /* Quantize, pick indices, then one least squares refinement if it helps */
+    uint16_t c0 = PackColor565(a), c1 = PackColor565(b);
+    uint32_t indices = 0;
+    float error = ChooseIndices(pixels, std::max(c0, c1), std::min(c0, c1), indices);
+    if (RefitEndpoints(pixels, indices, a, b) && c0 != c1)
+    {
+        uint16_t r0 = PackColor565(a), r1 = PackColor565(b);
+        uint32_t refitIndices;
+        if (r0 != r1 && ChooseIndices(pixels, std::max(r0, r1), std::min(r0, r1), refitIndices) < error)
+        {
+            c0 = r0;
+            c1 = r1;
+        }
+    }
+    if (c0 < c1)
+        std::swap(c0, c1);
+    if (c0 == c1)
+        indices = 0; // Solid block, every index points at c0
+    else
+        ChooseIndices(pixels, c0, c1, indices);
+
+    out[0] = c0 & 0xff;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xff;
+    out[3] = c1 >> 8;
+    memcpy(out + 4, &indices, 4); // Little endian, pixel 0 in the lowest bits
+}
+
+// 8 interpolated alpha values between the block's minimum and maximum
+static void EncodeAlphaBlock(const unsigned char pixels[16][4], unsigned char *out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i)
+    {
+        a0 = std::max(a0, (int)pixels[i][3]);
+        a1 = std::min(a1, (int)pixels[i][3]);
+    }
+    out[0] = a0;
+    out[1] = a1;
+
+    uint64_t indices = 0;
+    if (a0 > a1)
+    {
+        int palette[8] = {a0, a1};
+        for (int j = 1; j < 7; ++j)
+            palette[j + 1] = ((7 - j) * a0 + j * a1 + 3) / 7;
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0;
+            for (int j = 1; j < 8; ++j)
+                if (std::abs(palette[j] - pixels[i][3]) < std::abs(palette[best] - pixels[i][3]))
+                    best = j;
+            indices |= (uint64_t)best << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+static std::vector<unsigned char> EncodeImage(const unsigned char *pixels, int width, int height, Format format)
+{
+    if (format == Format::RGBA8)
+        return std::vector<unsigned char>(pixels, pixels + (size_t)width * height * 4);
+
+    /* Blocks are stored row by row; edge blocks of small levels repeat the last pixel */
+    int blockBytes = format == Format::BC1 ? 8 : 16;
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    std::vector<unsigned char> blocks((size_t)blocksX * blocksY * blockBytes);
+    unsigned char block[16][4];
+    for (int by = 0; by < blocksY; ++by)
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int x = std::min(bx * 4 + i % 4, width - 1), y = std::min(by * 4 + i / 4, height - 1);
+                memcpy(block[i], pixels + ((size_t)y * width + x) * 4, 4);
+            }
+            unsigned char *out = &blocks[((size_t)by * blocksX + bx) * blockBytes];
+            if (format == Format::BC3)
+            {
+                EncodeAlphaBlock(block, out);
+                out += 8;
+            }
+            EncodeColorBlock(block, out);
+        }
+    return blocks;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv)
+{
+    Format format = Format::Auto;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            if (name == "auto")
+                format = Format::Auto;
+            else if (name == "bc1")
+                format = Format::BC1;
+            else if (name == "bc3")
+                format = Format::BC3;
+            else if (name == "rgba8")
+                format = Format::RGBA8;
+            else
+            {
+                std::cout << "Unknown format " << name << std::endl;
+                return 1;
+            }
+        }
+        else
+            paths.push_back(arg);
+    }
+    if (paths.size() != 2)
+    {
+        std::cout << "Usage: texconv [--format auto|bc1|bc3|rgba8] input.png output.ktx" << std::endl;
+        return 1;
+    }
+
+    /* Bottom row first, like Texture loads PNGs */
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(1);
+    unsigned char *pixels = stbi_load(paths[0].c_str(), &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        std::cout << "Failed to load " << paths[0] << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+    if (format == Format::Auto)
+    {
+        format = Format::BC1;
+        for (size_t i = 3; i < (size_t)width * height * 4; i += 4)
+            if (pixels[i] != 255)
+            {
+                format = Format::BC3;
+                break;
+            }
+    }
+
+    std::vector<size_t> offsets;
+    std::vector<unsigned char> chain = Mipmap::GenerateChain(pixels, width, height, offsets);
+    std::vector<std::vector<unsigned char>> levels;
+    size_t encodedBytes = 0, rawBytes = 0;
+    for (int level = 0; level < Mipmap::GetLevelCount(width, height); ++level)
+    {
+        const unsigned char *source = level == 0 ? pixels : chain.data() + offsets[level - 1];
+        int levelWidth = Mipmap::GetLevelSize(width, level), levelHeight = Mipmap::GetLevelSize(height, level);
+        levels.push_back(EncodeImage(source, levelWidth, levelHeight, format));
+        encodedBytes += levels.back().size();
+        rawBytes += (size_t)levelWidth * levelHeight * 4;
+    }
+    stbi_image_free(pixels);
+
+    bool ok;
+    if (format == Format::RGBA8)
+        ok = KtxFile::Write(paths[1], GL_UNSIGNED_BYTE, GL_RGBA, GL_RGBA8, GL_RGBA, width, height, levels);
+    else if (format == Format::BC1)
+        ok = KtxFile::Write(paths[1], 0, 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_RGB, width, height, levels);
+    else
+        ok = KtxFile::Write(paths[1], 0, 0, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA, width, height, levels);
+    if (!ok)
+    {
+        std::cout << "Failed to write " << paths[1] << std::endl;
+        return 1;
+    }
+
+    const char *names[] = {"auto", "BC1", "BC3", "RGBA8"};
+    std::cout << paths[0] << " " << width << "x" << height << " -> " << paths[1] << " " << names[(int)format] << ", "
+              << levels.size() << " levels, " << encodedBytes << " bytes (RGBA8 " << rawBytes << ")" << std::endl;
+    return 0;
+}